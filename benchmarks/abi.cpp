@@ -0,0 +1,106 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+
+#include <benchmark/benchmark.h>
+#include <evt/chain/execution_context_impl.hpp>
+#include <evt/chain/contracts/abi_serializer.hpp>
+#include <evt/chain/contracts/evt_contract_abi.hpp>
+#include <fc/io/json.hpp>
+
+/*
+ * Benchmarks for converting action data between json and binary by interpreting ABI and via reflected types
+ */
+
+using namespace evt::chain;
+using namespace evt::chain::contracts;
+
+static const abi_serializer&
+get_abis() {
+    static auto abis = abi_serializer(evt_contract_abi(), std::chrono::hours(1));
+    return abis;
+}
+
+static const evt_execution_context&
+get_abi_exec_ctx() {
+    static auto exec_ctx = evt_execution_context();
+    return exec_ctx;
+}
+
+const char* abi_ndjson = R"=====(
+{
+  "name" : "cookie",
+  "creator" : "EVT8MGU4aKiVzqMtWi9zLpu8KuTHZWjQQrX475ycSxEkLd6aBpraX",
+  "issue" : {
+    "name" : "issue",
+    "threshold" : 1,
+    "authorizers": [{
+        "ref": "[A] EVT8MGU4aKiVzqMtWi9zLpu8KuTHZWjQQrX475ycSxEkLd6aBpraX",
+        "weight": 1
+      }
+    ]
+  },
+  "transfer": {
+    "name": "transfer",
+    "threshold": 1,
+    "authorizers": [{
+        "ref": "[G] .OWNER",
+        "weight": 1
+      }
+    ]
+  },
+  "manage": {
+    "name": "manage",
+    "threshold": 1,
+    "authorizers": [{
+        "ref": "[A] EVT8MGU4aKiVzqMtWi9zLpu8KuTHZWjQQrX475ycSxEkLd6aBpraX",
+        "weight": 1
+      }
+    ]
+  }
+}
+)=====";
+
+// range(0): 0 for interpreting ABI, 1 for reflected type
+static void
+BM_ABI_newdomain_binary_to_variant(benchmark::State& state) {
+    auto& abis     = get_abis();
+    auto& exec_ctx = get_abi_exec_ctx();
+
+    auto var  = fc::json::from_string(abi_ndjson);
+    auto data = abis.variant_to_binary("newdomain", var, exec_ctx);
+
+    for(auto _ : state) {
+        auto v = fc::variant();
+        if(state.range(0) == 0) {
+            v = abis.binary_to_variant("newdomain", data, exec_ctx);
+        }
+        else {
+            exec_ctx.binary_to_variant(N(newdomain), data, v);
+        }
+        benchmark::DoNotOptimize(v);
+    }
+}
+BENCHMARK(BM_ABI_newdomain_binary_to_variant)->Arg(0)->Arg(1);
+
+// range(0): 0 for interpreting ABI, 1 for reflected type
+static void
+BM_ABI_newdomain_variant_to_binary(benchmark::State& state) {
+    auto& abis     = get_abis();
+    auto& exec_ctx = get_abi_exec_ctx();
+
+    auto var = fc::json::from_string(abi_ndjson);
+
+    for(auto _ : state) {
+        auto data = bytes();
+        if(state.range(0) == 0) {
+            data = abis.variant_to_binary("newdomain", var, exec_ctx);
+        }
+        else {
+            exec_ctx.variant_to_binary(N(newdomain), var, data);
+        }
+        benchmark::DoNotOptimize(data);
+    }
+}
+BENCHMARK(BM_ABI_newdomain_variant_to_binary)->Arg(0)->Arg(1);
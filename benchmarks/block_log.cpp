@@ -0,0 +1,103 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <evt/chain/block_log.hpp>
+#include <evt/chain/genesis_state.hpp>
+
+/*
+ * Benchmarks for appending blocks to block log in different flush modes
+ * and reading blocks from plain and compressed block logs
+ */
+
+using namespace evt::chain;
+
+static std::vector<signed_block_ptr>
+create_blocks(size_t n) {
+    auto blocks = std::vector<signed_block_ptr>();
+    auto prev   = block_id_type();
+    for(auto i = 0u; i < n; i++) {
+        auto b       = std::make_shared<signed_block>();
+        b->previous  = prev;
+        b->timestamp = block_timestamp_type(i);
+        // pads block to a size similar with a block of several transactions
+        b->block_extensions.emplace_back(0, std::vector<char>(2048, (char)i));
+
+        prev = b->id();
+        blocks.emplace_back(std::move(b));
+    }
+    return blocks;
+}
+
+// Measures appending `range(1)` blocks to block log
+// range(0): flush mode, 0 for every block, 1 for group and 2 for background
+static void
+BM_BlockLog_append(benchmark::State& state) {
+    auto dir    = fc::path("/tmp/evt_benchmarks_block_log");
+    auto policy = block_log::flush_policy();
+    policy.mode = (block_log::flush_mode)state.range(0);
+
+    auto nblocks = (size_t)state.range(1);
+    auto blocks  = create_blocks(nblocks + 1);
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        if(fc::exists(dir)) {
+            fc::remove_all(dir);
+        }
+        auto log = block_log(dir, policy);
+        log.reset(genesis_state(), blocks[0]);
+        state.ResumeTiming();
+
+        for(auto i = 1u; i <= nblocks; i++) {
+            log.append(blocks[i]);
+        }
+        log.flush();
+    }
+    state.SetItemsProcessed(state.iterations() * nblocks);
+}
+BENCHMARK(BM_BlockLog_append)->Args({0, 10'000})->Args({1, 10'000})->Args({2, 10'000})->Unit(benchmark::kMillisecond);
+
+// Measures reading random blocks by number from a block log of `range(1)` blocks
+// range(0): 0 for plain block log, otherwise compressed into archive of chunks of `range(0)` blocks
+static void
+BM_BlockLog_read_by_num(benchmark::State& state) {
+    auto dir     = fc::path("/tmp/evt_benchmarks_block_log_read");
+    auto nblocks = (uint32_t)state.range(1);
+    auto blocks  = create_blocks(nblocks);
+
+    if(fc::exists(dir)) {
+        fc::remove_all(dir);
+    }
+    {
+        auto log = block_log(dir);
+        log.reset(genesis_state(), blocks[0]);
+        for(auto i = 1u; i < nblocks; i++) {
+            log.append(blocks[i]);
+        }
+    }
+    if(state.range(0) > 0) {
+        auto backup_dir = block_log::compress_log(dir, state.range(0));
+        fc::remove_all(backup_dir);
+    }
+
+    auto size = uint64_t(0);
+    for(auto file : {"blocks.log", "blocks.index", "blocks.zlog", "blocks.zindex"}) {
+        if(fc::exists(dir / file)) {
+            size += fc::file_size(dir / file);
+        }
+    }
+
+    auto log  = block_log(dir);
+    auto rand = std::mt19937();
+    auto dist = std::uniform_int_distribution<uint32_t>(1, nblocks);
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(log.read_block_by_num(dist(rand)));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["bytes_on_disk"] = size;
+}
+BENCHMARK(BM_BlockLog_read_by_num)->Args({0, 10'000})->Args({64, 10'000})->Args({256, 10'000})->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,64 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+
+#include <benchmark/benchmark.h>
+#include <evt/chain/execution_context_impl.hpp>
+
+/*
+ * Benchmarks for dispatching action index to the invoker of its current version
+ */
+
+using namespace evt::chain;
+
+template<uint64_t N>
+struct dispatch_only {
+    template<typename T>
+    static uint64_t
+    invoke(int& counter) {
+        counter += T::get_version();
+        return N;
+    }
+};
+
+static const evt_execution_context&
+get_exec_ctx() {
+    static auto exec_ctx = evt_execution_context();
+    return exec_ctx;
+}
+
+// Measures dispatching to action of index `range(0)`
+static void
+BM_Dispatch_action(benchmark::State& state) {
+    auto& exec_ctx = get_exec_ctx();
+    auto  index    = (int)state.range(0);
+    auto  counter  = 0;
+
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(exec_ctx.invoke<dispatch_only, uint64_t>(index, counter));
+    }
+    benchmark::DoNotOptimize(counter);
+}
+BENCHMARK(BM_Dispatch_action)->Apply([](benchmark::internal::Benchmark* b) {
+    for(auto i = 0; i < evt_execution_context::actions_count(); i++) {
+        b->Arg(i);
+    }
+});
+
+// Measures dispatching to all the actions in turn
+static void
+BM_Dispatch_all_actions(benchmark::State& state) {
+    auto& exec_ctx = get_exec_ctx();
+    auto  n        = evt_execution_context::actions_count();
+    auto  counter  = 0;
+
+    for(auto _ : state) {
+        for(auto i = 0; i < n; i++) {
+            benchmark::DoNotOptimize(exec_ctx.invoke<dispatch_only, uint64_t>(i, counter));
+        }
+    }
+    benchmark::DoNotOptimize(counter);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_Dispatch_all_actions);
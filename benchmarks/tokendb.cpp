@@ -0,0 +1,208 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+
+#include <sstream>
+#include <benchmark/benchmark.h>
+#include <evt/chain/snapshot.hpp>
+#include <evt/chain/token_database.hpp>
+#include <evt/chain/token_database_snapshot.hpp>
+#include <evt/testing/tester.hpp>
+#include <fc/io/json.hpp>
+
+/*
+ * Benchmarks for block applying against different token database write modes and for restoring snapshots
+ */
+
+using namespace evt::chain;
+using namespace evt::chain::contracts;
+
+static std::unique_ptr<evt::testing::tester>
+create_tokendb_tester(bool tokens_write_cache) {
+    using namespace evt::testing;
+
+    fc::logger::get().set_log_level(fc::log_level(fc::log_level::error));
+
+    auto dir = fc::path("/tmp/evt_benchmarks_tokendb");
+    if(fc::exists(dir)) {
+        fc::remove_all(dir);
+    }
+    fc::create_directories(dir);
+
+    auto cfg = controller::config();
+
+    cfg.blocks_dir            = dir / "blocks";
+    cfg.state_dir             = dir / "state";
+    cfg.db_config.db_path     = dir / "tokendb";
+    cfg.state_size            = 1024 * 1024 * 64;
+    cfg.reversible_cache_size = 1024 * 1024 * 64;
+    cfg.contracts_console     = false;
+    cfg.charge_free_mode      = true;
+    cfg.loadtest_mode         = true;
+
+    cfg.db_config.tokens_write_cache = tokens_write_cache;
+
+    cfg.genesis.initial_timestamp = fc::time_point::from_iso_string("2020-01-01T00:00:00.000");
+    cfg.genesis.initial_key       = tester::get_public_key("evt");
+    auto privkey                  = tester::get_private_key("evt");
+
+    auto t = std::make_unique<tester>(cfg);
+    t->block_signing_private_keys.insert(std::make_pair(cfg.genesis.initial_key, privkey));
+
+    return t;
+}
+
+const char* bdjson = R"=====(
+{
+  "name" : "bmtkdb",
+  "creator" : "EVT546WaW3zFAxEEEkYKjDiMvg3CHRjmWX2XdNxEhi69RpdKuQRSK",
+  "issue" : {
+    "name" : "issue",
+    "threshold" : 1,
+    "authorizers": [{
+        "ref": "[A] EVT546WaW3zFAxEEEkYKjDiMvg3CHRjmWX2XdNxEhi69RpdKuQRSK",
+        "weight": 1
+      }
+    ]
+  },
+  "transfer": {
+    "name": "transfer",
+    "threshold": 1,
+    "authorizers": [{
+        "ref": "[G] .OWNER",
+        "weight": 1
+      }
+    ]
+  },
+  "manage": {
+    "name": "manage",
+    "threshold": 1,
+    "authorizers": [{
+        "ref": "[A] EVT546WaW3zFAxEEEkYKjDiMvg3CHRjmWX2XdNxEhi69RpdKuQRSK",
+        "weight": 1
+      }
+    ]
+  }
+}
+)=====";
+
+// Measures pushing and producing one block of `range(1)` token transfers
+// range(0): 0 for writing tokens into db directly, 1 for using tokens write cache
+static void
+BM_TokenDB_apply_transfer_block(benchmark::State& state) {
+    auto tester = create_tokendb_tester(state.range(0));
+    auto ntrxs  = (int)state.range(1);
+
+    auto var   = fc::json::from_string(bdjson);
+    auto nd    = var.as<newdomain>();
+    nd.creator = evt::testing::tester::get_public_key("evt");
+    nd.issue.authorizers[0].ref.set_account(nd.creator);
+
+    auto auths = std::vector<name>{N(evt)};
+    tester->push_action(action(nd.name, N128(.create), nd), auths, address());
+
+    auto it   = issuetoken();
+    it.domain = nd.name;
+    it.owner  = {nd.creator};
+    for(int i = 0; i < ntrxs; i++) {
+        it.names.emplace_back(name128::from_number(i));
+    }
+    tester->push_action(action(nd.name, N128(.issue), it), auths, address());
+    tester->produce_block();
+
+    auto tt   = transfer();
+    tt.domain = nd.name;
+    tt.to     = {address(nd.creator)};
+
+    auto privkey = evt::testing::tester::get_private_key(N(evt));
+    auto round   = 0;
+
+    for(auto _ : state) {
+        state.PauseTiming();
+
+        auto trxs = std::vector<signed_transaction>(ntrxs);
+        tt.memo   = std::to_string(round++);
+        for(int i = 0; i < ntrxs; i++) {
+            tt.name = it.names[i];
+
+            auto& trx = trxs[i];
+            trx.actions.emplace_back(action(tt.domain, tt.name, tt));
+            tester->set_transaction_headers(trx, address());
+            trx.sign(privkey, tester->control->get_chain_id());
+        }
+
+        state.ResumeTiming();
+
+        for(auto& trx : trxs) {
+            tester->push_transaction(trx);
+        }
+        tester->produce_block();
+    }
+    state.SetItemsProcessed(state.iterations() * ntrxs);
+}
+BENCHMARK(BM_TokenDB_apply_transfer_block)->Args({0, 1'000})->Args({1, 1'000})->Unit(benchmark::kMillisecond);
+
+// Measures restoring token database from a snapshot of `range(1)` tokens and `range(1)` assets
+// range(0): 0 for writing rows one by one, 1 for bulk loading by ingesting sst files
+static void
+BM_TokenDB_restore_snapshot(benchmark::State& state) {
+    fc::logger::get().set_log_level(fc::log_level(fc::log_level::error));
+
+    auto dir = fc::path("/tmp/evt_benchmarks_tokendb_snapshot");
+    if(fc::exists(dir)) {
+        fc::remove_all(dir);
+    }
+    fc::create_directories(dir);
+
+    auto nrows = (int)state.range(1);
+    auto cfg   = token_database::config();
+    auto value = std::string(64, 'v');
+
+    cfg.db_path = dir / "source";
+
+    auto snapshot = std::string();
+    {
+        auto tokendb = token_database(cfg);
+        tokendb.open(false);
+
+        auto domain = N128(bmtkdb);
+        tokendb.put_token(token_type::domain, action_op::put, std::nullopt, domain, value);
+        tokendb.put_token(token_type::fungible, action_op::put, std::nullopt, name128(1), value);
+        for(int i = 0; i < nrows; i++) {
+            tokendb.put_token(token_type::token, action_op::put, domain, name128::from_number(i), value);
+
+            auto key = fc::ecc::public_key_data();
+            key[0]   = 0x02;
+            memcpy(key.data() + 1, &i, sizeof(i));
+            tokendb.put_asset(address(public_key_type(fc::ecc::public_key_shim(key))), 1, value);
+        }
+
+        auto ss     = std::stringstream();
+        auto writer = std::make_shared<ostream_snapshot_writer>(ss);
+        token_database_snapshot::add_to_snapshot(writer, tokendb);
+        writer->finalize();
+
+        snapshot = ss.str();
+    }
+
+    cfg.db_path      = dir / "restore";
+    cfg.bulk_restore = state.range(0);
+
+    for(auto _ : state) {
+        state.PauseTiming();
+
+        fc::remove_all(cfg.db_path);
+        auto tokendb = token_database(cfg);
+        tokendb.open(false);
+
+        auto ss     = std::stringstream(snapshot);
+        auto reader = std::make_shared<istream_snapshot_reader>(ss);
+
+        state.ResumeTiming();
+
+        token_database_snapshot::read_from_snapshot(reader, tokendb);
+    }
+    state.SetItemsProcessed(state.iterations() * nrows * 2);
+}
+BENCHMARK(BM_TokenDB_restore_snapshot)->Args({0, 100'000})->Args({1, 100'000})->Unit(benchmark::kMillisecond);
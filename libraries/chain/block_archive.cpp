@@ -0,0 +1,287 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+#include <evt/chain/block_archive.hpp>
+#include <evt/chain/exceptions.hpp>
+#include <cstring>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <fc/io/raw.hpp>
+#include <zstd.h>
+
+namespace evt { namespace chain {
+
+const uint32_t block_archive::version              = 1;
+const uint32_t block_archive::default_cache_chunks = 16;
+
+namespace detail {
+
+namespace bip = boost::interprocess;
+
+const auto archive_file_name   = "blocks.zlog";
+const auto index_file_name     = "blocks.zindex";
+const auto compression_level   = 9;  // archive is written once and read many times
+const auto archive_header_size = sizeof(uint32_t) * 4;
+
+using chunk_ptr = std::shared_ptr<const std::vector<char>>;
+
+class block_archive_impl {
+public:
+    block_archive_impl(const fc::path& data_dir, uint32_t cache_chunks)
+        : archive_file(data_dir / archive_file_name)
+        , index_file(data_dir / index_file_name)
+        , archive_mapping(archive_file.generic_string().c_str(), bip::read_only)
+        , archive_region(archive_mapping, bip::read_only)
+        , index_mapping(index_file.generic_string().c_str(), bip::read_only)
+        , index_region(index_mapping, bip::read_only)
+        , cache_chunks(cache_chunks) {
+        EVT_ASSERT(archive_region.get_size() >= archive_header_size, block_log_exception, "Block archive is malformed");
+
+        auto     data = (const char*)archive_region.get_address();
+        uint32_t ver;
+        memcpy(&ver, data, sizeof(ver));
+        memcpy(&first_block_num, data + sizeof(uint32_t), sizeof(uint32_t));
+        memcpy(&last_block_num, data + sizeof(uint32_t) * 2, sizeof(uint32_t));
+        memcpy(&blocks_per_chunk, data + sizeof(uint32_t) * 3, sizeof(uint32_t));
+        EVT_ASSERT(ver == block_archive::version, block_log_unsupported_version,
+            "Unsupported version of block archive. Block archive version is ${version} while code supports version ${v}",
+            ("version", ver)("v", block_archive::version));
+        EVT_ASSERT(first_block_num > 0 && last_block_num >= first_block_num && blocks_per_chunk > 0, block_log_exception,
+            "Block archive is malformed");
+
+        auto nchunks = (last_block_num - first_block_num) / blocks_per_chunk + 1;
+        EVT_ASSERT(index_region.get_size() == sizeof(uint64_t) * (nchunks + 1), block_log_exception,
+            "Block archive index is malformed");
+        EVT_ASSERT(chunk_pos(nchunks) == archive_region.get_size(), block_log_exception,
+            "Block archive index doesn't match the archive");
+    }
+
+public:
+    uint64_t
+    chunk_pos(uint32_t chunk) const {
+        uint64_t pos;
+        memcpy(&pos, (const char*)index_region.get_address() + sizeof(uint64_t) * chunk, sizeof(pos));
+        return pos;
+    }
+
+    chunk_ptr
+    decompress_chunk(uint32_t chunk) const {
+        auto pos  = chunk_pos(chunk);
+        auto end  = chunk_pos(chunk + 1);
+        auto data = (const char*)archive_region.get_address() + pos;
+        EVT_ASSERT(pos < end && end <= archive_region.get_size(), block_log_exception,
+            "Block archive index is malformed at chunk ${c}", ("c", chunk));
+
+        auto size = ZSTD_getFrameContentSize(data, end - pos);
+        EVT_ASSERT(size != ZSTD_CONTENTSIZE_UNKNOWN && size != ZSTD_CONTENTSIZE_ERROR, block_log_exception,
+            "Chunk ${c} of block archive is malformed", ("c", chunk));
+
+        auto buf = std::make_shared<std::vector<char>>(size);
+        auto r   = ZSTD_decompress(buf->data(), buf->size(), data, end - pos);
+        EVT_ASSERT(!ZSTD_isError(r) && r == size, block_log_exception,
+            "Cannot decompress chunk ${c} of block archive: ${e}", ("c", chunk)("e", ZSTD_isError(r) ? ZSTD_getErrorName(r) : "size mismatch"));
+        return buf;
+    }
+
+    chunk_ptr
+    get_chunk(uint32_t chunk) const {
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            auto it = cached.find(chunk);
+            if(it != cached.end()) {
+                lru.splice(lru.begin(), lru, it->second);
+                return it->second->second;
+            }
+        }
+
+        // decompresses without lock, other readers of the same chunk may do it at the same time
+        auto c = decompress_chunk(chunk);
+
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        if(cached.find(chunk) == cached.end() && cache_chunks > 0) {
+            if(lru.size() >= cache_chunks) {
+                cached.erase(lru.back().first);
+                lru.pop_back();
+            }
+            lru.emplace_front(chunk, c);
+            cached.emplace(chunk, lru.begin());
+        }
+        return c;
+    }
+
+    // returns packed block `i` in decompressed chunk
+    std::string_view
+    get_block(const std::vector<char>& chunk, uint32_t i) const {
+        uint32_t count;
+        EVT_ASSERT(chunk.size() >= sizeof(count), block_log_exception, "Chunk of block archive is malformed");
+        memcpy(&count, chunk.data(), sizeof(count));
+
+        auto header = sizeof(uint32_t) * (count + 2);
+        EVT_ASSERT(i < count && chunk.size() >= header, block_log_exception, "Chunk of block archive is malformed");
+
+        uint32_t pos, end;
+        memcpy(&pos, chunk.data() + sizeof(uint32_t) * (i + 1), sizeof(pos));
+        memcpy(&end, chunk.data() + sizeof(uint32_t) * (i + 2), sizeof(end));
+        EVT_ASSERT(pos <= end && header + end <= chunk.size(), block_log_exception, "Chunk of block archive is malformed");
+
+        return std::string_view(chunk.data() + header + pos, end - pos);
+    }
+
+public:
+    fc::path archive_file;
+    fc::path index_file;
+    uint32_t first_block_num  = 0;
+    uint32_t last_block_num   = 0;
+    uint32_t blocks_per_chunk = 0;
+
+    bip::file_mapping  archive_mapping;
+    bip::mapped_region archive_region;
+    bip::file_mapping  index_mapping;
+    bip::mapped_region index_region;
+
+    size_t                                                        cache_chunks;
+    mutable std::mutex                                            cache_mutex;
+    mutable std::list<std::pair<uint32_t, chunk_ptr>>             lru;
+    mutable std::unordered_map<uint32_t, decltype(lru)::iterator> cached;
+};
+
+}  // namespace detail
+
+block_archive::block_archive(const fc::path& data_dir, uint32_t cache_chunks)
+    : my(new detail::block_archive_impl(data_dir, cache_chunks)) {}
+
+block_archive::~block_archive() {}
+
+signed_block_ptr
+block_archive::read_block_by_num(uint32_t block_num) const {
+    if(block_num < my->first_block_num || block_num > my->last_block_num) {
+        return signed_block_ptr();
+    }
+
+    auto i     = block_num - my->first_block_num;
+    auto chunk = my->get_chunk(i / my->blocks_per_chunk);
+    auto data  = my->get_block(*chunk, i % my->blocks_per_chunk);
+
+    auto ds = fc::datastream<const char*>(data.data(), data.size());
+    auto b  = std::make_shared<signed_block>();
+    fc::raw::unpack(ds, *b);
+    EVT_ASSERT(b->block_num() == block_num, block_log_exception,
+        "Wrong block was read from block archive.", ("returned", b->block_num())("expected", block_num));
+    return b;
+}
+
+uint32_t
+block_archive::read_raw_blocks(uint32_t first_num, uint32_t last_num, const block_log::raw_block_func& func) const {
+    first_num = std::max(first_num, my->first_block_num);
+    last_num  = std::min(last_num, my->last_block_num);
+
+    auto num = first_num;
+    while(num <= last_num) {
+        auto i     = num - my->first_block_num;
+        auto chunk = my->get_chunk(i / my->blocks_per_chunk);
+
+        num++;
+        if(!func(num - 1, my->get_block(*chunk, i % my->blocks_per_chunk))) {
+            break;
+        }
+    }
+    return num - first_num;
+}
+
+uint32_t
+block_archive::first_block_num() const {
+    return my->first_block_num;
+}
+
+uint32_t
+block_archive::last_block_num() const {
+    return my->last_block_num;
+}
+
+bool
+block_archive::exists(const fc::path& data_dir) {
+    return fc::exists(data_dir / detail::archive_file_name);
+}
+
+void
+block_archive::remove(const fc::path& data_dir) {
+    fc::remove_all(data_dir / detail::archive_file_name);
+    fc::remove_all(data_dir / detail::index_file_name);
+}
+
+void
+block_archive::copy(const fc::path& from_dir, const fc::path& to_dir) {
+    fc::copy(from_dir / detail::archive_file_name, to_dir / detail::archive_file_name);
+    fc::copy(from_dir / detail::index_file_name, to_dir / detail::index_file_name);
+}
+
+void
+block_archive::create(const fc::path& data_dir, const block_log& log, uint32_t first_num, uint32_t last_num, uint32_t blocks_per_chunk) {
+    EVT_ASSERT(first_num > 0 && first_num <= last_num, block_log_exception, "Invalid range of blocks to archive");
+    EVT_ASSERT(blocks_per_chunk > 0, block_log_exception, "Blocks per chunk of block archive should be greater than 0");
+
+    // archive is written into temporary files and renamed once completed, a partial archive is never opened
+    auto archive_file = data_dir / (std::string(detail::archive_file_name) + ".tmp");
+    auto index_file   = data_dir / (std::string(detail::index_file_name) + ".tmp");
+
+    auto archive_stream = std::ofstream(archive_file.generic_string().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    auto index_stream   = std::ofstream(index_file.generic_string().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    archive_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+    index_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+
+    archive_stream.write((char*)&version, sizeof(version));
+    archive_stream.write((char*)&first_num, sizeof(first_num));
+    archive_stream.write((char*)&last_num, sizeof(last_num));
+    archive_stream.write((char*)&blocks_per_chunk, sizeof(blocks_per_chunk));
+
+    auto offsets = std::vector<uint32_t>();
+    auto blocks  = std::vector<char>();
+    auto chunk   = std::vector<char>();
+    auto frame   = std::vector<char>();
+
+    uint64_t pos = detail::archive_header_size;
+    for(uint64_t num = first_num; num <= last_num; num += blocks_per_chunk) {
+        auto last = (uint32_t)std::min<uint64_t>(num + blocks_per_chunk - 1, last_num);
+
+        offsets.clear();
+        blocks.clear();
+        auto n = log.read_raw_blocks(num, last, [&](auto, auto& data) {
+            offsets.emplace_back(blocks.size());
+            blocks.insert(blocks.end(), data.begin(), data.end());
+            return true;
+        });
+        EVT_ASSERT(n == last - num + 1, block_log_exception, "Cannot read blocks ${f} to ${l} from block log", ("f", num)("l", last));
+        offsets.emplace_back(blocks.size());
+
+        uint32_t count = n;
+        chunk.resize(sizeof(uint32_t) * (offsets.size() + 1) + blocks.size());
+        memcpy(chunk.data(), &count, sizeof(count));
+        memcpy(chunk.data() + sizeof(count), offsets.data(), sizeof(uint32_t) * offsets.size());
+        memcpy(chunk.data() + sizeof(uint32_t) * (offsets.size() + 1), blocks.data(), blocks.size());
+
+        frame.resize(ZSTD_compressBound(chunk.size()));
+        auto r = ZSTD_compress(frame.data(), frame.size(), chunk.data(), chunk.size(), detail::compression_level);
+        EVT_ASSERT(!ZSTD_isError(r), block_log_exception, "Cannot compress blocks into block archive: ${e}", ("e", ZSTD_getErrorName(r)));
+
+        archive_stream.write(frame.data(), r);
+        index_stream.write((char*)&pos, sizeof(pos));
+        pos += r;
+
+        if(last % 10000 < blocks_per_chunk) {
+            ilog2_("Archived blocks up to {:n}", last);
+        }
+    }
+    index_stream.write((char*)&pos, sizeof(pos));
+
+    archive_stream.close();
+    index_stream.close();
+    fc::rename(archive_file, data_dir / detail::archive_file_name);
+    fc::rename(index_file, data_dir / detail::index_file_name);
+}
+
+}}  // namespace evt::chain
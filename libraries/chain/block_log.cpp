@@ -3,8 +3,19 @@
  *  @copyright defined in evt/LICENSE.txt
  */
 #include <evt/chain/block_log.hpp>
+#include <evt/chain/block_archive.hpp>
 #include <evt/chain/exceptions.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <fstream>
+#include <mutex>
+#include <thread>
+#include <boost/noncopyable.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include <fc/io/raw.hpp>
 
 #define LOG_READ (std::ios::in | std::ios::binary)
@@ -23,6 +34,37 @@ const uint32_t block_log::min_supported_version = 1;
 const uint32_t block_log::max_supported_version = 2;
 
 namespace detail {
+
+/**
+ * Read-only mapping of the first `size` bytes of a file.
+ * Mappings are immutable, a larger one replaces it when the file grows and
+ * the old one is released after the last reader holding it is done.
+ */
+class mapped_file : boost::noncopyable {
+public:
+    mapped_file(const fc::path& file, uint64_t size)
+        : mapping_(file.generic_string().c_str(), boost::interprocess::read_only)
+        , region_(mapping_, boost::interprocess::read_only, 0, size) {}
+
+public:
+    const char* data() const { return (const char*)region_.get_address(); }
+    uint64_t    size() const { return region_.get_size(); }
+
+private:
+    boost::interprocess::file_mapping  mapping_;
+    boost::interprocess::mapped_region region_;
+};
+
+using mapped_file_ptr = std::shared_ptr<const mapped_file>;
+
+// appended block which is not flushed and published to readers of mappings yet
+struct pending_block {
+    signed_block_ptr  block;
+    uint64_t          pos;
+    uint64_t          end;   // end of block and its trailing position in block file
+    std::vector<char> data;  // packed block, only kept for writer thread in background mode
+};
+
 class block_log_impl {
 public:
     signed_block_ptr head;
@@ -37,6 +79,304 @@ public:
     uint32_t         version                      = 0;
     uint32_t         first_block_num              = 0;
 
+    // compressed blocks before `first_block_num`, if any
+    std::unique_ptr<block_archive> archive;
+
+    // readers only see the flushed part of files through mappings, they never touch the streams above
+    std::mutex            map_mutex;
+    mapped_file_ptr       block_map;
+    mapped_file_ptr       index_map;
+    std::atomic<uint64_t> block_size = 0;
+    std::atomic<uint64_t> index_size = 0;
+    std::atomic<uint64_t> head_end   = 0;  // end of head block and its position, published after index
+    std::atomic<uint32_t> head_num   = 0;
+
+    // returns a mapping covering all the bytes flushed so far, which are at least `end` bytes
+    mapped_file_ptr
+    get_map(mapped_file_ptr& map, const fc::path& file, const std::atomic<uint64_t>& file_size, uint64_t end) {
+        auto size = file_size.load(std::memory_order_acquire);
+        EVT_ASSERT(end <= size, block_log_exception, "Read beyond the end of block log file: ${file}", ("file", file.generic_string()));
+
+        auto m = std::atomic_load(&map);
+        if(m && m->size() >= size) {
+            return m;
+        }
+
+        std::lock_guard<std::mutex> lock(map_mutex);
+        m = std::atomic_load(&map);
+        if(!m || m->size() < size) {
+            m = std::make_shared<mapped_file>(file, size);
+            std::atomic_store(&map, m);
+        }
+        return m;
+    }
+
+    // publishes current sizes of files to readers, called after the streams are flushed
+    void
+    sync_sizes() {
+        block_size.store(fc::file_size(block_file), std::memory_order_release);
+        index_size.store(fc::file_size(index_file), std::memory_order_release);
+        head_end.store(block_size.load(), std::memory_order_release);
+
+        end_pos   = block_size;
+        index_end = index_size;
+    }
+
+    // appended blocks not published yet, they're looked up before mappings by readers
+    // and removed after being published, so a block is always found by one of them
+    block_log::flush_policy   policy;
+    uint64_t                  end_pos   = 0;  // end of block file including all the appended blocks
+    uint64_t                  index_end = 0;  // end of index file including all the appended blocks
+    fc::time_point            last_flush;
+    mutable std::mutex        pending_mutex;
+    std::condition_variable   pending_cv;
+    std::deque<pending_block> pendings;
+    std::exception_ptr        writer_except;
+    bool                      writer_stop = false;
+    std::thread               writer;
+
+    ~block_log_impl() {
+        stop_writer();
+    }
+
+    void
+    write_block(const std::vector<char>& data, uint64_t pos) {
+        check_block_write();
+        check_index_write();
+        block_stream.write(data.data(), data.size());
+        block_stream.write((char*)&pos, sizeof(pos));
+        index_stream.write((char*)&pos, sizeof(pos));
+    }
+
+    // makes blocks up to `pb` visible through mappings, block is published before its index entry
+    void
+    publish(const pending_block& pb) {
+        block_size.store(pb.end, std::memory_order_release);
+        index_size.store(sizeof(uint64_t) * (pb.block->block_num() - first_block_num + 1), std::memory_order_release);
+        head_end.store(pb.end, std::memory_order_release);
+        head_num.store(pb.block->block_num(), std::memory_order_release);
+    }
+
+    void
+    add_block(pending_block&& pb) {
+        switch(policy.mode) {
+        case block_log::flush_mode::every_block: {
+            write_block(pb.data, pb.pos);
+            block_stream.flush();
+            index_stream.flush();
+            publish(pb);
+            break;
+        }
+        case block_log::flush_mode::group: {
+            write_block(pb.data, pb.pos);
+            pb.data.clear();
+
+            auto lock = std::unique_lock<std::mutex>(pending_mutex);
+            pendings.emplace_back(std::move(pb));
+            auto full = pendings.size() >= policy.max_blocks;
+            lock.unlock();
+
+            if(full || (fc::time_point::now() - last_flush) >= fc::milliseconds(policy.max_ms)) {
+                flush();
+            }
+            break;
+        }
+        case block_log::flush_mode::background: {
+            // appending waits when there are too many blocks not flushed yet
+            auto lock = std::unique_lock<std::mutex>(pending_mutex);
+            pending_cv.wait(lock, [this] { return pendings.size() < policy.max_blocks || writer_except; });
+            check_writer();
+            pendings.emplace_back(std::move(pb));
+            lock.unlock();
+
+            pending_cv.notify_all();
+            break;
+        }
+        }  // switch
+    }
+
+    void
+    flush() {
+        if(policy.mode == block_log::flush_mode::background) {
+            auto lock = std::unique_lock<std::mutex>(pending_mutex);
+            pending_cv.wait(lock, [this] { return pendings.empty() || writer_except; });
+            check_writer();
+        }
+
+        // writer thread is idle when there are no pending blocks
+        block_stream.flush();
+        index_stream.flush();
+        last_flush = fc::time_point::now();
+
+        auto lock = std::unique_lock<std::mutex>(pending_mutex);
+        if(!pendings.empty()) {
+            publish(pendings.back());
+            pendings.clear();
+        }
+    }
+
+    // background mode: writes and flushes pending blocks in batches, readers keep finding them in `pendings` until published
+    void
+    run_writer() {
+        auto lock = std::unique_lock<std::mutex>(pending_mutex);
+        while(true) {
+            pending_cv.wait(lock, [this] { return !pendings.empty() || writer_stop; });
+            if(pendings.empty()) {
+                return;
+            }
+
+            // appending only pushes back, which keeps references to the elements valid
+            auto batch = std::vector<const pending_block*>();
+            for(auto& pb : pendings) {
+                batch.emplace_back(&pb);
+            }
+            lock.unlock();
+
+            try {
+                for(auto pb : batch) {
+                    write_block(pb->data, pb->pos);
+                }
+                block_stream.flush();
+                index_stream.flush();
+            }
+            catch(...) {
+                lock.lock();
+                writer_except = std::current_exception();
+                pending_cv.notify_all();
+                return;
+            }
+
+            lock.lock();
+            publish(*batch.back());
+            pendings.erase(pendings.begin(), pendings.begin() + batch.size());
+            pending_cv.notify_all();
+        }
+    }
+
+    void
+    start_writer() {
+        if(policy.mode == block_log::flush_mode::background) {
+            writer = std::thread([this] { run_writer(); });
+        }
+    }
+
+    void
+    stop_writer() {
+        if(!writer.joinable()) {
+            return;
+        }
+        {
+            auto lock   = std::unique_lock<std::mutex>(pending_mutex);
+            writer_stop = true;
+        }
+        pending_cv.notify_all();
+        writer.join();
+    }
+
+    // rethrows the failure of writer thread, called with `pending_mutex` locked
+    void
+    check_writer() {
+        if(writer_except) {
+            std::rethrow_exception(writer_except);
+        }
+    }
+
+    // lookups of pending blocks are called with `pending_mutex` locked
+    const pending_block*
+    find_pending(uint32_t block_num) const {
+        if(pendings.empty() || block_num < pendings.front().block->block_num()) {
+            return nullptr;
+        }
+        auto i = block_num - pendings.front().block->block_num();
+        return i < pendings.size() ? &pendings[i] : nullptr;
+    }
+
+    const pending_block*
+    find_pending_pos(uint64_t pos) const {
+        for(auto& pb : pendings) {
+            if(pb.pos == pos) {
+                return &pb;
+            }
+        }
+        return nullptr;
+    }
+
+    // returns size of block file without the torn tail left by blocks which were not completely flushed
+    uint64_t
+    valid_log_size(uint64_t log_size, uint64_t index_size) const {
+        auto log = mapped_file(block_file, log_size);
+
+        // returns end of block and its trailing position at `pos`, 0 if it's torn
+        auto block_end = [&](uint64_t pos) -> uint64_t {
+            if(pos >= log_size) {
+                return 0;
+            }
+            try {
+                auto ds = fc::datastream<const char*>(log.data() + pos, log_size - pos);
+                auto b  = signed_block();
+                fc::raw::unpack(ds, b);
+
+                auto end = pos + ds.tellp();
+                if(end + sizeof(uint64_t) > log_size) {
+                    return 0;
+                }
+                uint64_t trailer;
+                memcpy(&trailer, log.data() + end, sizeof(trailer));
+                return trailer == pos ? end + sizeof(trailer) : 0;
+            }
+            catch(...) {
+                return 0;
+            }
+        };
+
+        uint64_t head_pos;
+        memcpy(&head_pos, log.data() + log_size - sizeof(head_pos), sizeof(head_pos));
+        if(head_pos == block_log::npos || block_end(head_pos) == log_size) {
+            return log_size;
+        }
+
+        // find the last complete block from index, then walk forward since index may be behind
+        auto end = uint64_t(0);
+        if(index_size >= sizeof(uint64_t)) {
+            auto index = mapped_file(index_file, index_size);
+            for(auto i = index_size / sizeof(uint64_t); i > 0 && end == 0; i--) {
+                uint64_t pos;
+                memcpy(&pos, index.data() + (i - 1) * sizeof(pos), sizeof(pos));
+                end = block_end(pos);
+            }
+        }
+        if(end == 0) {
+            // skip version, first block num, genesis and totem
+            auto ds  = fc::datastream<const char*>(log.data(), log_size);
+            auto ver = uint32_t(0);
+            fc::raw::unpack(ds, ver);
+            if(ver > 1) {
+                ds.skip(sizeof(uint32_t));
+            }
+            auto gs = genesis_state();
+            fc::raw::unpack(ds, gs);
+            if(ver > 1) {
+                ds.skip(sizeof(uint64_t));
+            }
+            end = ds.tellp();
+        }
+        for(auto next = block_end(end); next != 0; next = block_end(end)) {
+            end = next;
+        }
+        return end;
+    }
+
+    void
+    reset_maps() {
+        std::lock_guard<std::mutex> lock(map_mutex);
+        std::atomic_store(&block_map, mapped_file_ptr());
+        std::atomic_store(&index_map, mapped_file_ptr());
+        block_size = 0;
+        index_size = 0;
+        head_end   = 0;
+        head_num   = 0;
+    }
+
     inline void
     check_block_read() {
         if(block_write) {
@@ -76,13 +416,44 @@ public:
         }
     }
 };
+// moves blocks directory to a backup location and creates an empty one, returns both of them
+std::pair<fc::path, fc::path>
+backup_blocks_dir(const fc::path& data_dir, const fc::time_point& now) {
+    auto blocks_dir = fc::canonical(data_dir);
+    if(blocks_dir.filename().generic_string() == ".") {
+        blocks_dir = blocks_dir.parent_path();
+    }
+    auto backup_dir      = blocks_dir.parent_path();
+    auto blocks_dir_name = blocks_dir.filename();
+    EVT_ASSERT(blocks_dir_name.generic_string() != ".", block_log_exception, "Invalid path to blocks directory");
+    backup_dir = backup_dir / blocks_dir_name.generic_string().append("-").append(now);
+
+    EVT_ASSERT(!fc::exists(backup_dir), block_log_backup_dir_exist,
+               "Cannot move existing blocks directory to already existing directory '${new_blocks_dir}'",
+               ("new_blocks_dir", backup_dir));
+
+    fc::rename(blocks_dir, backup_dir);
+    ilog("Moved existing blocks directory to backup location: '${new_blocks_dir}'", ("new_blocks_dir", backup_dir));
+
+    fc::create_directories(blocks_dir);
+    return std::make_pair(blocks_dir, backup_dir);
+}
+
 }  // namespace detail
 
 block_log::block_log(const fc::path& data_dir)
+    : block_log(data_dir, flush_policy()) {}
+
+block_log::block_log(const fc::path& data_dir, const flush_policy& policy)
     : my(new detail::block_log_impl()) {
+    EVT_ASSERT(policy.mode == flush_mode::every_block || policy.max_blocks > 0, block_log_exception,
+        "Max unflushed blocks of block log should be greater than 0");
+
+    my->policy = policy;
     my->block_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
     my->index_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
     open(data_dir);
+    my->start_writer();
 }
 
 block_log::block_log(block_log&& other) {
@@ -102,12 +473,18 @@ block_log::open(const fc::path& data_dir) {
         my->block_stream.close();
     if(my->index_stream.is_open())
         my->index_stream.close();
+    my->reset_maps();
 
     if(!fc::is_directory(data_dir))
         fc::create_directories(data_dir);
     my->block_file = data_dir / "blocks.log";
     my->index_file = data_dir / "blocks.index";
 
+    my->archive.reset();
+    if(block_archive::exists(data_dir)) {
+        my->archive = std::make_unique<block_archive>(data_dir);
+    }
+
     //ilog("Opening block log at ${path}", ("path", my->block_file.generic_string()));
     my->block_stream.open(my->block_file.generic_string().c_str(), LOG_WRITE);
     my->index_stream.open(my->index_file.generic_string().c_str(), LOG_WRITE);
@@ -135,8 +512,22 @@ block_log::open(const fc::path& data_dir) {
     auto log_size   = fc::file_size(my->block_file);
     auto index_size = fc::file_size(my->index_file);
 
+    if(log_size) {
+        // blocks not completely flushed before last shutdown can leave a torn tail in any flush mode
+        auto valid_size = my->valid_log_size(log_size, index_size);
+        if(valid_size < log_size) {
+            wlog("Block log has a torn tail of ${n} bytes which is truncated", ("n", log_size - valid_size));
+            my->block_stream.close();
+            fc::resize_file(my->block_file, valid_size);
+            my->block_stream.open(my->block_file.generic_string().c_str(), LOG_WRITE);
+            log_size = valid_size;
+        }
+    }
+
     if(log_size) {
         ilog("Log is nonempty");
+        my->block_size = log_size;
+        my->head_end   = log_size;
         my->check_block_read();
         my->block_stream.seekg(0);
         my->version = 0;
@@ -156,10 +547,29 @@ block_log::open(const fc::path& data_dir) {
             my->first_block_num = 1;
         }
 
-        my->head    = read_head();
-        my->head_id = my->head->id();
+        if(my->archive) {
+            EVT_ASSERT(my->archive->last_block_num() + 1 == my->first_block_num, block_log_exception,
+                "Block log doesn't continue from the last block of block archive, expected first block ${e} but got ${n}",
+                ("e", my->archive->last_block_num() + 1)("n", my->first_block_num));
+        }
+
+        // head may be in the archive when block log has no blocks after it
+        my->head = read_head();
+        if(my->head) {
+            my->head_id = my->head->id();
+            if(my->head->block_num() >= my->first_block_num) {
+                my->head_num = my->head->block_num();
+            }
+        }
 
-        if(index_size) {
+        if(my->head_num == 0) {
+            ilog("Log has no blocks after genesis, recreate index");
+            my->index_stream.close();
+            fc::remove_all(my->index_file);
+            my->index_stream.open(my->index_file.generic_string().c_str(), LOG_WRITE);
+            my->index_write = true;
+        }
+        else if(index_size) {
             my->check_block_read();
             my->check_index_read();
 
@@ -193,6 +603,9 @@ block_log::open(const fc::path& data_dir) {
         my->index_stream.open(my->index_file.generic_string().c_str(), LOG_WRITE);
         my->index_write = true;
     }
+
+    flush();
+    my->sync_sizes();
 }
 
 uint64_t
@@ -200,23 +613,19 @@ block_log::append(const signed_block_ptr& b) {
     try {
         EVT_ASSERT(my->genesis_written_to_block_log, block_log_append_fail, "Cannot append to block log until the genesis is first written");
 
-        my->check_block_write();
-        my->check_index_write();
-
-        uint64_t pos = my->block_stream.tellp();
-        EVT_ASSERT((size_t)my->index_stream.tellp() == sizeof(uint64_t) * (b->block_num() - my->first_block_num),
+        // positions are tracked here since streams may be written by writer thread
+        uint64_t pos = my->end_pos;
+        EVT_ASSERT(my->index_end == sizeof(uint64_t) * (b->block_num() - my->first_block_num),
                    block_log_append_fail,
                    "Append to index file occuring at wrong position.",
-                   ("position", (uint64_t)my->index_stream.tellp())("expected", (b->block_num() - my->first_block_num) * sizeof(uint64_t)));
+                   ("position", my->index_end)("expected", (b->block_num() - my->first_block_num) * sizeof(uint64_t)));
         auto data = fc::raw::pack(*b);
-        my->block_stream.write(data.data(), data.size());
-        my->block_stream.write((char*)&pos, sizeof(pos));
-        my->index_stream.write((char*)&pos, sizeof(pos));
+        my->end_pos += data.size() + sizeof(pos);
+        my->index_end += sizeof(pos);
         my->head    = b;
         my->head_id = b->id();
 
-        flush();
-
+        my->add_block(detail::pending_block { b, pos, my->end_pos, std::move(data) });
         return pos;
     }
     FC_LOG_AND_RETHROW()
@@ -224,20 +633,27 @@ block_log::append(const signed_block_ptr& b) {
 
 void
 block_log::flush() {
-    my->block_stream.flush();
-    my->index_stream.flush();
+    my->flush();
 }
 
 void
 block_log::reset(const genesis_state& gs, const signed_block_ptr& first_block, uint32_t first_block_num) {
+    flush();
     if(my->block_stream.is_open())
         my->block_stream.close();
     if(my->index_stream.is_open())
         my->index_stream.close();
 
+    my->reset_maps();
     fc::remove_all(my->block_file);
     fc::remove_all(my->index_file);
 
+    // archive is only kept when the new log continues from it
+    if(my->archive && (first_block || my->archive->last_block_num() + 1 != first_block_num)) {
+        my->archive.reset();
+        block_archive::remove(my->block_file.parent_path());
+    }
+
     my->block_stream.open(my->block_file.generic_string().c_str(), LOG_WRITE);
     my->index_stream.open(my->index_file.generic_string().c_str(), LOG_WRITE);
     my->block_write = true;
@@ -256,7 +672,10 @@ block_log::reset(const genesis_state& gs, const signed_block_ptr& first_block, u
     my->block_stream.write((char*)&totem, sizeof(totem));
 
     if(first_block) {
+        my->end_pos   = my->block_stream.tellp();
+        my->index_end = 0;
         append(first_block);
+        flush();
     }
 
     auto pos = my->block_stream.tellp();
@@ -273,23 +692,42 @@ block_log::reset(const genesis_state& gs, const signed_block_ptr& first_block, u
 
     my->block_write = false;
     my->check_block_write();  // Reset to append-only writing.
+    my->sync_sizes();
 }
 
 std::pair<signed_block_ptr, uint64_t>
 block_log::read_block(uint64_t pos) const {
-    my->check_block_read();
+    {
+        auto lock = std::unique_lock<std::mutex>(my->pending_mutex);
+        if(auto pb = my->find_pending_pos(pos)) {
+            return std::make_pair(pb->block, pb->end);
+        }
+    }
 
-    my->block_stream.seekg(pos);
+    auto map = my->get_map(my->block_map, my->block_file, my->block_size, pos + sizeof(uint64_t));
+
+    auto ds = fc::datastream<const char*>(map->data() + pos, map->size() - pos);
     std::pair<signed_block_ptr, uint64_t> result;
     result.first = std::make_shared<signed_block>();
-    fc::raw::unpack(my->block_stream, *result.first);
-    result.second = uint64_t(my->block_stream.tellg()) + 8;
+    fc::raw::unpack(ds, *result.first);
+    result.second = pos + ds.tellp() + 8;
     return result;
 }
 
 signed_block_ptr
 block_log::read_block_by_num(uint32_t block_num) const {
     try {
+        {
+            auto lock = std::unique_lock<std::mutex>(my->pending_mutex);
+            if(auto pb = my->find_pending(block_num)) {
+                return pb->block;
+            }
+        }
+
+        if(my->archive && block_num < my->first_block_num) {
+            return my->archive->read_block_by_num(block_num);
+        }
+
         signed_block_ptr b;
         uint64_t         pos = get_block_pos(block_num);
         if(pos != npos) {
@@ -302,35 +740,114 @@ block_log::read_block_by_num(uint32_t block_num) const {
     FC_LOG_AND_RETHROW()
 }
 
+uint32_t
+block_log::read_raw_blocks(uint32_t first_num, uint32_t last_num, const raw_block_func& func) const {
+    auto archived = uint32_t(0);
+    if(my->archive && first_num < my->first_block_num) {
+        auto stop = false;
+        archived  = my->archive->read_raw_blocks(first_num, last_num, [&](auto num, auto& data) {
+            stop = !func(num, data);
+            return !stop;
+        });
+        if(stop) {
+            return archived;
+        }
+    }
+
+    first_num = std::max(first_num, my->first_block_num);
+    last_num  = std::min(last_num, my->head_num.load(std::memory_order_acquire));
+    if(first_num > last_num) {
+        return archived;
+    }
+
+    // blocks may be appended concurrently: end of the latest block is loaded before the mappings,
+    // if a newer block is appended after that its index entry will be visible in index mapping
+    auto head_end = my->head_end.load(std::memory_order_acquire);
+    auto index    = my->get_map(my->index_map, my->index_file, my->index_size, sizeof(uint64_t) * (last_num - my->first_block_num + 1));
+    auto map      = my->get_map(my->block_map, my->block_file, my->block_size, head_end);
+
+    auto index_pos = [&](uint32_t num) {
+        auto offset = sizeof(uint64_t) * (num - my->first_block_num);
+        if(offset + sizeof(uint64_t) > index->size()) {
+            return npos;
+        }
+        uint64_t pos;
+        memcpy(&pos, index->data() + offset, sizeof(pos));
+        return pos;
+    };
+
+    auto pos = index_pos(first_num);
+    auto num = first_num;
+    while(num <= last_num) {
+        auto next = index_pos(num + 1);
+        auto end  = (next != npos ? next : head_end) - sizeof(uint64_t);
+        EVT_ASSERT(end >= pos && end + sizeof(uint64_t) <= map->size(), block_log_exception,
+            "Block log index is malformed at block ${num}", ("num", num));
+
+        // every block is followed by its position
+        uint64_t trailer;
+        memcpy(&trailer, map->data() + end, sizeof(trailer));
+        EVT_ASSERT(trailer == pos, block_log_exception, "Block ${num} is not found in block log at indexed position", ("num", num));
+
+        num++;
+        if(!func(num - 1, std::string_view(map->data() + pos, end - pos))) {
+            break;
+        }
+        pos = next;
+    }
+    return archived + (num - first_num);
+}
+
 uint64_t
 block_log::get_block_pos(uint32_t block_num) const {
-    my->check_index_read();
-    if(!(my->head && block_num <= block_header::num_from_id(my->head_id) && block_num >= my->first_block_num))
+    {
+        auto lock = std::unique_lock<std::mutex>(my->pending_mutex);
+        if(auto pb = my->find_pending(block_num)) {
+            return pb->pos;
+        }
+    }
+
+    if(!(block_num <= my->head_num.load(std::memory_order_acquire) && block_num >= my->first_block_num))
         return npos;
-    my->index_stream.seekg(sizeof(uint64_t) * (block_num - my->first_block_num));
+
+    auto offset = sizeof(uint64_t) * (block_num - my->first_block_num);
+    auto map    = my->get_map(my->index_map, my->index_file, my->index_size, offset + sizeof(uint64_t));
+
     uint64_t pos;
-    my->index_stream.read((char*)&pos, sizeof(pos));
+    memcpy(&pos, map->data() + offset, sizeof(pos));
     return pos;
 }
 
 signed_block_ptr
 block_log::read_head() const {
-    my->check_block_read();
+    {
+        auto lock = std::unique_lock<std::mutex>(my->pending_mutex);
+        if(!my->pendings.empty()) {
+            return my->pendings.back().block;
+        }
+    }
 
     uint64_t pos;
 
-    // Check that the file is not empty
-    my->block_stream.seekg(0, std::ios::end);
-    if((size_t)my->block_stream.tellg() <= sizeof(pos))
+    auto archive_head = [this]() -> signed_block_ptr {
+        if(my->archive) {
+            return my->archive->read_block_by_num(my->archive->last_block_num());
+        }
         return {};
+    };
+
+    // Check that the file is not empty
+    auto end = my->head_end.load(std::memory_order_acquire);
+    if(end <= sizeof(pos))
+        return archive_head();
 
-    my->block_stream.seekg(-sizeof(pos), std::ios::end);
-    my->block_stream.read((char*)&pos, sizeof(pos));
+    auto map = my->get_map(my->block_map, my->block_file, my->block_size, end);
+    memcpy(&pos, map->data() + end - sizeof(pos), sizeof(pos));
     if(pos != npos) {
         return read_block(pos).first;
     }
     else {
-        return {};
+        return archive_head();
     }
 }
 
@@ -341,7 +858,7 @@ block_log::head() const {
 
 uint32_t
 block_log::first_block_num() const {
-    return my->first_block_num;
+    return my->archive ? my->archive->first_block_num() : my->first_block_num;
 }
 
 void
@@ -396,25 +913,17 @@ block_log::repair_log(const fc::path& data_dir, uint32_t truncate_at_block) {
 
     auto now = fc::time_point::now();
 
-    auto blocks_dir = fc::canonical(data_dir);
-    if(blocks_dir.filename().generic_string() == ".") {
-        blocks_dir = blocks_dir.parent_path();
-    }
-    auto backup_dir      = blocks_dir.parent_path();
-    auto blocks_dir_name = blocks_dir.filename();
-    EVT_ASSERT(blocks_dir_name.generic_string() != ".", block_log_exception, "Invalid path to blocks directory");
-    backup_dir = backup_dir / blocks_dir_name.generic_string().append("-").append(now);
-
-    EVT_ASSERT(!fc::exists(backup_dir), block_log_backup_dir_exist,
-               "Cannot move existing blocks directory to already existing directory '${new_blocks_dir}'",
-               ("new_blocks_dir", backup_dir));
-
-    fc::rename(blocks_dir, backup_dir);
-    ilog("Moved existing blocks directory to backup location: '${new_blocks_dir}'", ("new_blocks_dir", backup_dir));
-
-    fc::create_directories(blocks_dir);
+    auto [blocks_dir, backup_dir] = detail::backup_blocks_dir(data_dir, now);
     auto block_log_path = blocks_dir / "blocks.log";
 
+    // archived blocks are immutable and only the log after them is recovered
+    if(block_archive::exists(backup_dir)) {
+        auto archive = block_archive(backup_dir);
+        EVT_ASSERT(truncate_at_block == 0 || truncate_at_block > archive.last_block_num(), block_log_exception,
+            "Cannot truncate at block ${n} which is in block archive", ("n", truncate_at_block));
+        block_archive::copy(backup_dir, blocks_dir);
+    }
+
     ilog("Reconstructing '${new_block_log}' from backed up block log", ("new_block_log", block_log_path));
 
     std::fstream old_block_stream;
@@ -560,6 +1069,40 @@ block_log::repair_log(const fc::path& data_dir, uint32_t truncate_at_block) {
     return backup_dir;
 }
 
+fc::path
+block_log::compress_log(const fc::path& data_dir, uint32_t blocks_per_chunk) {
+    ilog("Compressing Block Log...");
+    EVT_ASSERT(fc::is_directory(data_dir) && fc::is_regular_file(data_dir / "blocks.log"), block_log_not_found,
+               "Block log not found in '${blocks_dir}'", ("blocks_dir", data_dir));
+    EVT_ASSERT(blocks_per_chunk > 0, block_log_exception, "Blocks per chunk of block archive should be greater than 0");
+
+    auto [blocks_dir, backup_dir] = detail::backup_blocks_dir(data_dir, fc::time_point::now());
+
+    // already archived blocks are included since they're read through the old log as well
+    auto old_log = block_log(backup_dir);
+    auto head    = old_log.head();
+    EVT_ASSERT(head, block_log_exception, "Block log has no blocks to compress");
+
+    auto first   = old_log.first_block_num();
+    auto nchunks = (head->block_num() - first + 1) / blocks_per_chunk;
+    EVT_ASSERT(nchunks > 0, block_log_exception, "Block log has fewer blocks than one chunk of ${n} blocks", ("n", blocks_per_chunk));
+    auto last = first + nchunks * blocks_per_chunk - 1;
+
+    ilog("Compressing blocks ${f} to ${l} into block archive", ("f", first)("l", last));
+    block_archive::create(blocks_dir, old_log, first, last, blocks_per_chunk);
+
+    // blocks not filling a chunk are kept in the new block log which continues from archive
+    auto log = block_log(blocks_dir);
+    log.reset(extract_genesis_state(backup_dir), signed_block_ptr(), last + 1);
+    for(auto num = last + 1; num <= head->block_num(); num++) {
+        log.append(old_log.read_block_by_num(num));
+    }
+    log.flush();
+
+    ilog("Block log is compressed, ${n} blocks are kept uncompressed in block log", ("n", head->block_num() - last));
+    return backup_dir;
+}
+
 genesis_state
 block_log::extract_genesis_state(const fc::path& data_dir) {
     EVT_ASSERT(fc::is_directory(data_dir) && fc::is_regular_file(data_dir / "blocks.log"), block_log_not_found,
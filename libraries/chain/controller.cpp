@@ -4,6 +4,10 @@
  */
 #include <evt/chain/controller.hpp>
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include <chainbase/chainbase.hpp>
 #include <fmt/format.h>
 
@@ -11,13 +15,16 @@
 #include <fc/scoped_exit.hpp>
 #include <fc/variant_object.hpp>
 
+#include <evt/chain/authority_cache.hpp>
 #include <evt/chain/authority_checker.hpp>
 #include <evt/chain/block_log.hpp>
 #include <evt/chain/charge_manager.hpp>
 #include <evt/chain/chain_snapshot.hpp>
 #include <evt/chain/execution_context_impl.hpp>
 #include <evt/chain/fork_database.hpp>
+#include <evt/chain/holder_dist_cache.hpp>
 #include <evt/chain/snapshot.hpp>
+#include <evt/chain/thread_utils.hpp>
 #include <evt/chain/token_database.hpp>
 #include <evt/chain/token_database_cache.hpp>
 #include <evt/chain/token_database_snapshot.hpp>
@@ -54,6 +61,11 @@ public:
         _token_session = token_db.new_savepoint_session(db.revision());
     }
 
+    // token database only, used when chainbase undo sessions are skipped
+    explicit maybe_session(token_database& token_db, int64_t seq) {
+        _token_session = token_db.new_savepoint_session(seq);
+    }
+
     maybe_session(const maybe_session&) = delete;
 
     void
@@ -131,6 +143,121 @@ struct pending_state {
     }
 };
 
+/**
+ *  Transactions of one block whose metadata (ids and recovered signing keys) are being
+ *  prepared on the thread pool before the block is applied sequentially.
+ *  There is one future for each receipt, suspend receipts have invalid futures.
+ */
+struct prepared_block {
+    signed_block_ptr                                   block;
+    std::vector<std::future<transaction_metadata_ptr>> trxs;
+};
+
+/**
+ *  Reads blocks from block log on a background thread during replay and prepares them
+ *  into a bounded queue, so applying blocks doesn't wait for reading and unpacking them.
+ */
+class replay_reader : boost::noncopyable {
+public:
+    using prepare_func = std::function<prepared_block(const signed_block_ptr&)>;
+
+public:
+    replay_reader(const block_log& blog, uint32_t start_num, size_t capacity, prepare_func&& prepare)
+        : blog_(blog)
+        , next_num_(start_num)
+        , capacity_(capacity)
+        , prepare_(std::move(prepare)) {
+        thread_ = std::thread([this] { run(); });
+    }
+
+    ~replay_reader() {
+        {
+            auto lock = std::unique_lock<std::mutex>(mutex_);
+            stop_     = true;
+        }
+        not_full_.notify_one();
+        thread_.join();
+    }
+
+public:
+    // waits for next block, returns an empty one at the end of block log
+    prepared_block
+    next() {
+        auto lock = std::unique_lock<std::mutex>(mutex_);
+        not_empty_.wait(lock, [this] { return !queue_.empty() || done_; });
+        if(queue_.empty()) {
+            if(except_) {
+                std::rethrow_exception(except_);
+            }
+            return prepared_block();
+        }
+
+        auto pb = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+
+        not_full_.notify_one();
+        return pb;
+    }
+
+    size_t
+    size() const {
+        auto lock = std::unique_lock<std::mutex>(mutex_);
+        return queue_.size();
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    void
+    run() {
+        try {
+            while(true) {
+                auto b = blog_.read_block_by_num(next_num_++);
+                if(!b) {
+                    break;
+                }
+                auto pb = prepare_(b);
+
+                auto lock = std::unique_lock<std::mutex>(mutex_);
+                not_full_.wait(lock, [this] { return queue_.size() < capacity_ || stop_; });
+                if(stop_) {
+                    return;
+                }
+                queue_.emplace_back(std::move(pb));
+                lock.unlock();
+
+                not_empty_.notify_one();
+            }
+        }
+        catch(...) {
+            auto lock = std::unique_lock<std::mutex>(mutex_);
+            except_   = std::current_exception();
+        }
+
+        {
+            auto lock = std::unique_lock<std::mutex>(mutex_);
+            done_     = true;
+        }
+        not_empty_.notify_one();
+    }
+
+private:
+    const block_log& blog_;
+    uint32_t         next_num_;
+    size_t           capacity_;
+    prepare_func     prepare_;
+
+    mutable std::mutex         mutex_;
+    std::condition_variable    not_empty_;
+    std::condition_variable    not_full_;
+    std::deque<prepared_block> queue_;
+    bool                       done_ = false;
+    bool                       stop_ = false;
+    std::exception_ptr         except_;
+    std::thread                thread_;
+};
+
 struct controller_impl {
     controller&              self;
     chainbase::database      db;
@@ -141,12 +268,15 @@ struct controller_impl {
     fork_database            fork_db;
     token_database           token_db;
     token_database_cache     token_db_cache;
+    authority_cache          auth_cache;
+    holder_dist_cache        holder_cache;
     controller::config       conf;
     chain_id_type            chain_id;
     evt_execution_context    exec_ctx;
 
 
     bool                     replaying = false;
+    bool                     replaying_fast = false;
     optional<fc::time_point> replay_head_time;
     db_read_mode             read_mode = db_read_mode::SPECULATIVE;
     bool                     in_trx_requiring_checks = false; ///< if true, checks that are normally skipped on replay (e.g. auth checks) cannot be skipped
@@ -154,6 +284,9 @@ struct controller_impl {
     uint32_t                 snapshot_head_block = 0;
     abi_serializer           system_api;
 
+    optional<boost::asio::thread_pool> thread_pool;     ///< recovers signatures of transactions ahead of applying
+    std::deque<prepared_block>         prepared_blocks; ///< blocks read ahead from block log during replay
+
     /**
      *  Transactions that were undone by pop_block or abort_block, transactions
      *  are removed from this list if they are re-applied in other blocks. Producers
@@ -189,10 +322,12 @@ struct controller_impl {
         , reversible_blocks(cfg.blocks_dir / config::reversible_blocks_dir_name,
              cfg.read_only ? database::read_only : database::read_write,
              cfg.reversible_cache_size)
-        , blog(cfg.blocks_dir)
+        , blog(cfg.blocks_dir, cfg.blog_flush_policy)
         , fork_db(cfg.state_dir)
         , token_db(cfg.db_config)
         , token_db_cache(token_db, cfg.db_config.object_cache_size)
+        , auth_cache(token_db, cfg.auth_cache_size)
+        , holder_cache(token_db, cfg.holder_cache_size)
         , conf(cfg)
         , chain_id(cfg.genesis.compute_chain_id())
         , exec_ctx()
@@ -202,9 +337,17 @@ struct controller_impl {
         fork_db.irreversible.connect([&](auto b) {
             on_irreversible(b);
         });
+
+        if(cfg.signature_recovery_threads > 0) {
+            thread_pool.emplace(cfg.signature_recovery_threads);
+        }
     }
 
     ~controller_impl() {
+        prepared_blocks.clear();
+        if(thread_pool) {
+            thread_pool->join();
+        }
         pending.reset();
         db.flush();
         reversible_blocks.flush();
@@ -269,7 +412,10 @@ struct controller_impl {
         }
 
         db.commit(s->block_num);
-        token_db.pop_savepoints(s->block_num);
+        if(!replaying_fast) {
+            // fast replay persists token savepoints in batches by itself
+            token_db.pop_savepoints(s->block_num);
+        }
 
         if(append_to_blog) {
             blog.append(s->block);
@@ -316,13 +462,66 @@ struct controller_impl {
         ilog("existing block log, attempting to replay from ${s} to ${n} blocks",
             ("s", fmt::format("{:n}", start_block_num))("n", fmt::format("{:n}", blog_head->block_num())));
 
-        auto start = fc::time_point::now();
-        while(auto next = blog.read_block_by_num(head->block_num + 1)) {
+        auto start     = fc::time_point::now();
+        auto trx_count = 0ull;
+
+        // blocks are read, unpacked and prepared ahead on reader thread, which also keeps
+        // a window of blocks whose signatures are being recovered on thread pool
+        auto reader    = std::make_unique<replay_reader>(blog, head->block_num + 1, config::default_replay_recovery_ahead, [this](auto& b) {
+            return prepare_block(b);
+        });
+        auto read_next = [&]() -> signed_block_ptr {
+            auto pb = reader->next();
+            if(!pb.block) {
+                return signed_block_ptr();
+            }
+            prepared_blocks.emplace_back(std::move(pb));
+            return prepared_blocks.front().block;
+        };
+        auto report_time = start;
+        auto report_num  = head->block_num;
+
+        // fast replay applies each irreversible block under one token db savepoint kept in write cache,
+        // and persists the savepoints of a batch of blocks in one write
+        auto write_cache = token_db.tokens_write_cache();
+        replaying_fast   = conf.replay_fast && self.skip_db_sessions(controller::block_status::irreversible);
+        if(replaying_fast) {
+            ilog("fast replay is enabled, transaction checks are skipped for irreversible blocks");
+            token_db.set_tokens_write_cache(true);
+        }
+        auto end_fast = [&, this] {
+            if(replaying_fast) {
+                token_db.pop_savepoints(head->block_num + 1);
+                token_db.set_tokens_write_cache(write_cache);
+                replaying_fast = false;
+            }
+        };
+        auto reset_fast = fc::make_scoped_exit([&] {
+            end_fast();
+        });
+
+        while(auto next = read_next()) {
             replay_push_block(next, controller::block_status::irreversible);
+            if(replaying_fast && next->block_num() % config::default_replay_fast_flush_blocks == 0) {
+                token_db.pop_savepoints(head->block_num + 1);
+            }
+            if(!prepared_blocks.empty() && prepared_blocks.front().block == next) {
+                // block was not applied (e.g. irreversible read mode), drop its prepared transactions
+                prepared_blocks.pop_front();
+            }
+            trx_count += next->transactions.size();
             if(next->block_num() % 500 == 0) {
-                ilog2_("{:n} of {:n}", next->block_num(), blog_head->block_num());
+                auto now = fc::time_point::now();
+                auto bps = (next->block_num() - report_num) * 1000000.0 / std::max<int64_t>((now - report_time).count(), 1);
+                ilog2_("{:n} of {:n}, {:.1f} blocks/s, read-ahead queue {}/{}", next->block_num(), blog_head->block_num(),
+                    bps, reader->size(), reader->capacity());
+                report_time = now;
+                report_num  = next->block_num();
             }
         }
+        reader.reset();
+        prepared_blocks.clear();
+        end_fast();
         std::cerr << "\n";
         ilog("${n} blocks replayed", ("n", fmt::format("{:n}", head->block_num - start_block_num)));
 
@@ -339,10 +538,11 @@ struct controller_impl {
 
         ilog("${n} reversible blocks replayed", ("n", fmt::format("{:n}", rev)));
         auto end = fc::time_point::now();
-        ilog("replayed ${n} blocks in ${duration} seconds, ${mspb} ms/block",
+        ilog("replayed ${n} blocks in ${duration} seconds, ${mspb} ms/block, ${tps} trx/s",
             ("n", fmt::format("{:n}", head->block_num - start_block_num))
             ("duration", fmt::format("{:n}", (end - start).count() / 1000000))
             ("mspb", fmt::format("{:.3f}", ((end - start).count() / 1000.0) / (head->block_num - start_block_num)))
+            ("tps", fmt::format("{:.1f}", trx_count * 1000000.0 / std::max<int64_t>((end - start).count(), 1)))
             );
         replaying = false;
         replay_head_time.reset();
@@ -435,6 +635,12 @@ struct controller_impl {
 
     void
     add_to_snapshot(const snapshot_writer_ptr& snapshot) const {
+        add_chain_state_to_snapshot(snapshot);
+        token_database_snapshot::add_to_snapshot(snapshot, token_db, conf.snapshot_threads);
+    }
+
+    void
+    add_chain_state_to_snapshot(const snapshot_writer_ptr& snapshot) const {
         snapshot->write_section<chain_snapshot_header>([this](auto& section) {
             section.add_row(chain_snapshot_header(), db);
         });
@@ -456,8 +662,6 @@ struct controller_impl {
                 });
             });
         });
-
-        token_database_snapshot::add_to_snapshot(snapshot, token_db);
     }
 
     void
@@ -817,6 +1021,9 @@ struct controller_impl {
 
             pending.emplace(maybe_session(db, token_db));
         }
+        else if(replaying_fast) {
+            pending.emplace(maybe_session(token_db, head->block_num + 1));
+        }
         else {
             pending.emplace(maybe_session());
         }
@@ -866,21 +1073,78 @@ struct controller_impl {
         static_cast<signed_block_header&>(*p->block) = p->header;
     }  /// sign_block
 
+    /**
+     *  Creates the metadata of all the input transactions in block `b` and recovers their
+     *  signing keys on the thread pool, so sequential execution finds them in `signing_keys`.
+     *  Without the thread pool only the metadata is created, in the calling thread.
+     */
+    prepared_block
+    prepare_block(const signed_block_ptr& b) {
+        auto pb  = prepared_block();
+        pb.block = b;
+        pb.trxs.reserve(b->transactions.size());
+
+        for(auto i = 0u; i < b->transactions.size(); i++) {
+            if(b->transactions[i].type != transaction_receipt::input) {
+                pb.trxs.emplace_back();
+                continue;
+            }
+            if(!thread_pool) {
+                auto p = std::promise<transaction_metadata_ptr>();
+                p.set_value(std::make_shared<transaction_metadata>(std::make_shared<packed_transaction>(b->transactions[i].trx)));
+                pb.trxs.emplace_back(p.get_future());
+                continue;
+            }
+            pb.trxs.emplace_back(async_thread_pool(*thread_pool, [b, i, id = chain_id] {
+                auto mtrx = std::make_shared<transaction_metadata>(std::make_shared<packed_transaction>(b->transactions[i].trx));
+                try {
+                    mtrx->recover_keys(id);
+                }
+                catch(...) {
+                    // leave keys empty, failure will be raised again when the transaction is checked in order
+                }
+                return mtrx;
+            }));
+        }
+        return pb;
+    }
+
+    std::vector<std::future<transaction_metadata_ptr>>
+    take_prepared_trxs(const signed_block_ptr& b) {
+        if(!prepared_blocks.empty() && prepared_blocks.front().block == b) {
+            auto trxs = std::move(prepared_blocks.front().trxs);
+            prepared_blocks.pop_front();
+            return trxs;
+        }
+        if(thread_pool && b->transactions.size() > 1) {
+            return prepare_block(b).trxs;
+        }
+        return {};
+    }
+
     void
     apply_block(const signed_block_ptr& b, controller::block_status s) {
         try {
             try {
                 EVT_ASSERT(b->block_extensions.size() == 0, block_validate_exception, "no supported extensions");
                 auto producer_block_id = b->id();
+                auto prepared_trxs     = take_prepared_trxs(b);
                 start_block(b->timestamp, b->confirmed, s, producer_block_id);
 
                 auto num_pending_receipts = pending->_pending_block_state->block->transactions.size();
-                for(const auto& receipt : b->transactions) {
+                for(auto i = 0u; i < b->transactions.size(); i++) {
+                    const auto& receipt = b->transactions[i];
+
                     auto trace = transaction_trace_ptr();
                     if(receipt.type == transaction_receipt::input) {
-                        auto& pt    = receipt.trx;
-                        auto  mtrx  = std::make_shared<transaction_metadata>(std::make_shared<packed_transaction>(pt));
-                        
+                        auto mtrx = transaction_metadata_ptr();
+                        if(!prepared_trxs.empty()) {
+                            mtrx = prepared_trxs[i].get();
+                        }
+                        else {
+                            mtrx = std::make_shared<transaction_metadata>(std::make_shared<packed_transaction>(receipt.trx));
+                        }
+
                         trace = push_transaction(mtrx, fc::time_point::maximum());
                     }
                     else if(receipt.type == transaction_receipt::suspend) {
@@ -1208,6 +1472,21 @@ controller::token_db_cache() const {
     return my->token_db_cache;
 }
 
+authority_cache&
+controller::auth_cache() const {
+    return my->auth_cache;
+}
+
+holder_dist_cache&
+controller::holder_cache() const {
+    return my->holder_cache;
+}
+
+void
+controller::on_applied_everipay(const evt_link_object& link_obj) {
+    my->emit(applied_everipay, link_obj);
+}
+
 charge_manager
 controller::get_charge_manager() const {
     return charge_manager(*this, my->exec_ctx);
@@ -1398,6 +1677,17 @@ controller::fetch_block_by_number(uint32_t block_num) const {
     FC_CAPTURE_AND_RETHROW((block_num))
 }
 
+uint32_t
+controller::fetch_raw_blocks(uint32_t first_num, uint32_t last_num, const block_log::raw_block_func& func) const {
+    // only irreversible blocks in block log are available as raw bytes
+    return my->blog.read_raw_blocks(first_num, last_num, func);
+}
+
+signed_block_ptr
+controller::fetch_irreversible_block_by_number(uint32_t block_num) const {
+    return my->blog.read_block_by_num(block_num);
+}
+
 block_state_ptr
 controller::fetch_block_state_by_id(block_id_type id) const {
     auto state = my->fork_db.get_block(id);
@@ -1470,6 +1760,24 @@ controller::write_snapshot(const snapshot_writer_ptr& snapshot) const {
     return my->add_to_snapshot(snapshot);
 }
 
+void
+controller::write_snapshot_checkpoint(const snapshot_writer_ptr& snapshot, const fc::path& checkpoint_dir) const {
+    EVT_ASSERT(!my->pending.has_value(), block_validate_exception, "cannot take a consistent snapshot with a pending block");
+    my->add_chain_state_to_snapshot(snapshot);
+    my->token_db.create_checkpoint(checkpoint_dir);
+}
+
+void
+controller::write_snapshot_from_checkpoint(const snapshot_writer_ptr& snapshot, const fc::path& checkpoint_dir) const {
+    auto cfg    = my->conf.db_config;
+    cfg.db_path = checkpoint_dir;
+
+    auto token_db = token_database(cfg);
+    token_db.open(false);
+    token_database_snapshot::add_to_snapshot(snapshot, token_db, my->conf.snapshot_threads);
+    token_db.close(false);
+}
+
 void
 controller::pop_block() {
     my->pop_block();
@@ -1600,6 +1908,11 @@ controller::skip_trx_checks() const {
     return light_validation_allowed(my->conf.disable_replay_opts);
 }
 
+bool
+controller::replay_fast_mode() const {
+    return my->replaying_fast && skip_db_sessions();
+}
+
 bool
 controller::loadtest_mode() const {
     return my->conf.loadtest_mode;
@@ -0,0 +1,99 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <boost/noncopyable.hpp>
+#include <boost/dynamic_bitset.hpp>
+#include <evt/chain/token_database.hpp>
+
+namespace evt { namespace chain {
+
+/**
+ * Memo of authority check results shared between authority checkers.
+ *
+ * Results are keyed by the identity of permission or group together with the signing keys.
+ * All the results are dropped when domains, groups or fungibles are updated or token values are rolled back.
+ */
+class authority_cache : boost::noncopyable {
+public:
+    struct entry {
+        bool                            satisfied;
+        boost::dynamic_bitset<uint64_t> used_keys;  // keys used by this check, indexed as the signing keys
+    };
+
+    struct stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t invalidations;
+        uint64_t size;
+    };
+
+public:
+    authority_cache(token_database& db, size_t max_entries)
+        : max_entries_(max_entries) {
+        watch_db(db);
+    }
+
+public:
+    bool enabled() const { return max_entries_ > 0; }
+
+    const entry*
+    lookup(const std::string& key) {
+        auto it = memo_.find(key);
+        if(it == memo_.end()) {
+            misses_++;
+            return nullptr;
+        }
+        hits_++;
+        return &it->second;
+    }
+
+    void
+    insert(std::string&& key, bool satisfied, const boost::dynamic_bitset<uint64_t>& used_keys) {
+        if(memo_.size() >= max_entries_) {
+            // results are cheap to rebuild, simply start over
+            memo_.clear();
+        }
+        memo_.emplace(std::move(key), entry { satisfied, used_keys });
+    }
+
+    void
+    invalidate() {
+        if(memo_.empty()) {
+            return;
+        }
+        memo_.clear();
+        invalidations_++;
+    }
+
+    stats
+    get_stats() const {
+        return stats { hits_, misses_, invalidations_, memo_.size() };
+    }
+
+private:
+    void
+    watch_db(token_database& db) {
+        db.rollback_token_value.connect([this](auto&) {
+            invalidate();
+        });
+        db.remove_token_value.connect([this](auto&) {
+            invalidate();
+        });
+    }
+
+private:
+    size_t                                 max_entries_;
+    std::unordered_map<std::string, entry> memo_;
+
+    uint64_t hits_          = 0;
+    uint64_t misses_        = 0;
+    uint64_t invalidations_ = 0;
+};
+
+}}  // namespace evt::chain
+
+FC_REFLECT(evt::chain::authority_cache::stats, (hits)(misses)(invalidations)(size));
@@ -10,6 +10,7 @@
 #include <boost/dynamic_bitset.hpp>
 #include <boost/range/algorithm/find.hpp>
 
+#include <evt/chain/authority_cache.hpp>
 #include <evt/chain/controller.hpp>
 #include <evt/chain/config.hpp>
 #include <evt/chain/execution_context_impl.hpp>
@@ -29,6 +30,7 @@ namespace internal {
 
 enum permission_type { kIssue = 0, kTransfer, kManage };
 enum toke_type { kNFT = 0, kFT };
+enum memo_kind { kMemoGroup = 0, kMemoDomain = 1, kMemoFungible = 4 };  // permission type is added to domain and fungible
 
 template<uint64_t>
 struct check_authority {};
@@ -60,6 +62,7 @@ private:
     const uint32_t               max_recursion_depth_;
 
     token_database_cache&           tokendb_cache_;
+    authority_cache&                auth_cache_;
     boost::dynamic_bitset<uint64_t> used_keys_;
 
 public:
@@ -111,6 +114,7 @@ public:
         , signing_keys_(signing_keys)
         , max_recursion_depth_(max_recursion_depth)
         , tokendb_cache_(control.token_db_cache())
+        , auth_cache_(control.auth_cache())
         , used_keys_(signing_keys.size(), false) {}
 
 private:
@@ -198,6 +202,51 @@ private:
     } 
 
 private:
+    std::string
+    make_memo_key(int kind, const name128& name, const address* owner = nullptr) const {
+        auto pack = [&](auto& ds) {
+            fc::raw::pack(ds, (uint8_t)kind);
+            fc::raw::pack(ds, name);
+            for(auto& key : signing_keys_) {
+                fc::raw::pack(ds, key);
+            }
+            if(owner != nullptr) {
+                fc::raw::pack(ds, *owner);
+            }
+        };
+
+        auto ss = fc::datastream<size_t>();
+        pack(ss);
+
+        auto key = std::string(ss.tellp(), '\0');
+        auto ds  = fc::datastream<char*>(key.data(), key.size());
+        pack(ds);
+
+        return key;
+    }
+
+    // Result and used keys of `eval` are memoized in authority cache with `key`
+    template<typename Eval>
+    bool
+    memoized(std::string&& key, Eval&& eval) {
+        auto e = auth_cache_.lookup(key);
+        if(e != nullptr) {
+            used_keys_ |= e->used_keys;
+            return e->satisfied;
+        }
+
+        // start with no used keys to capture the ones used by `eval` only
+        auto prev_keys = used_keys_;
+        auto restore   = fc::make_scoped_exit([&]() {
+            used_keys_ |= prev_keys;
+        });
+        used_keys_.reset();
+
+        auto result = eval();
+        auth_cache_.insert(std::move(key), result, used_keys_);
+        return result;
+    }
+
     bool
     satisfied_node(const group& group, const group::node& node, uint32_t depth) {
         FC_ASSERT(depth < max_recursion_depth_);
@@ -226,13 +275,33 @@ private:
 
     bool
     satisfied_group(const group_name& name) {
-        bool result = false;
-        get_group(name, [&](const auto& group) {
-            if(satisfied_node(group, group.root(), 0)) {
-                result = true;
+        using namespace internal;
+
+        auto eval = [&] {
+            bool result = false;
+            get_group(name, [&](const auto& group) {
+                if(satisfied_node(group, group.root(), 0)) {
+                    result = true;
+                }
+            });
+            return result;
+        };
+
+        if(!auth_cache_.enabled()) {
+            return eval();
+        }
+        return memoized(make_memo_key(kMemoGroup, name), eval);
+    }
+
+    // owner refs depend on the tokens, only results for fungibles can be memoized by its owner
+    static bool
+    has_owner_ref(const permission_def& permission) {
+        for(const auto& aw : permission.authorizers) {
+            if(aw.ref.is_owner_ref()) {
+                return true;
             }
-        });
-        return result;
+        }
+        return false;
     }
 
     template<int Token>
@@ -317,7 +386,13 @@ private:
 
         bool result = false;
         get_domain_permission<Permission>(action.domain, [&](const auto& permission) {
-            result = satisfied_permission<kNFT>(permission, action);
+            if(!auth_cache_.enabled() || has_owner_ref(permission)) {
+                result = satisfied_permission<kNFT>(permission, action);
+                return;
+            }
+            result = memoized(make_memo_key(kMemoDomain + Permission, action.domain), [&] {
+                return satisfied_permission<kNFT>(permission, action);
+            });
         });
         return result;
     }
@@ -329,7 +404,23 @@ private:
 
         bool result = false;
         get_fungible_permission<Permission>(sym_id, [&](const auto& permission) {
-            result = satisfied_permission<kFT>(permission, action);
+            if(!auth_cache_.enabled()) {
+                result = satisfied_permission<kFT>(permission, action);
+                return;
+            }
+
+            auto key = std::string();
+            if(has_owner_ref(permission)) {
+                get_ft_owner(action, [&](const auto& owner) {
+                    key = make_memo_key(kMemoFungible + Permission, name128::from_number(sym_id), &owner);
+                });
+            }
+            else {
+                key = make_memo_key(kMemoFungible + Permission, name128::from_number(sym_id));
+            }
+            result = memoized(std::move(key), [&] {
+                return satisfied_permission<kFT>(permission, action);
+            });
         });
         return result;
     }
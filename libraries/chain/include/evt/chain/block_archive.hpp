@@ -0,0 +1,63 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+#pragma once
+#include <evt/chain/block_log.hpp>
+
+namespace evt { namespace chain {
+
+namespace detail {
+class block_archive_impl;
+}
+
+/* The block archive is a read-only, compressed store of the oldest blocks of a block log. Blocks are
+    * grouped in chunks of a fixed number of blocks and each chunk is compressed into one zstd frame.
+    *
+    * blocks.zlog:
+    * +---------+-----------------+----------------+------------------+---------+---------+-----+
+    * | Version | First Block Num | Last Block Num | Blocks Per Chunk | Chunk 0 | Chunk 1 | ... |
+    * +---------+-----------------+----------------+------------------+---------+---------+-----+
+    *
+    * blocks.zindex:
+    * +----------------+----------------+-----+----------------------+
+    * | Pos of Chunk 0 | Pos of Chunk 1 | ... | End of Last Chunk    |
+    * +----------------+----------------+-----+----------------------+
+    *
+    * Decompressed chunk is the number of blocks in it, offsets of the blocks and the end of the last one,
+    * followed by the packed blocks. Reading a block only decompresses its chunk, and recent chunks are
+    * kept decompressed in a small LRU cache.
+    *
+    * When an archive exists in blocks directory, the block log continues from the block after the last
+    * archived one and falls back to the archive for reading older blocks.
+    */
+class block_archive {
+public:
+    block_archive(const fc::path& data_dir, uint32_t cache_chunks = default_cache_chunks);
+    ~block_archive();
+
+public:
+    // reads are safe to call from any thread
+    signed_block_ptr read_block_by_num(uint32_t block_num) const;
+    uint32_t         read_raw_blocks(uint32_t first_num, uint32_t last_num, const block_log::raw_block_func& func) const;
+
+    uint32_t first_block_num() const;
+    uint32_t last_block_num() const;
+
+public:
+    static bool exists(const fc::path& data_dir);
+    static void remove(const fc::path& data_dir);
+    static void copy(const fc::path& from_dir, const fc::path& to_dir);
+
+    // compresses blocks in [first_num, last_num] of `log` into an archive in `data_dir`
+    static void create(const fc::path& data_dir, const block_log& log, uint32_t first_num, uint32_t last_num, uint32_t blocks_per_chunk);
+
+public:
+    static const uint32_t version;
+    static const uint32_t default_cache_chunks;
+
+private:
+    std::unique_ptr<detail::block_archive_impl> my;
+};
+
+}}  // namespace evt::chain
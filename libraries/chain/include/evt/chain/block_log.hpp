@@ -3,6 +3,8 @@
  *  @copyright defined in evt/LICENSE.txt
  */
 #pragma once
+#include <functional>
+#include <string_view>
 #include <fc/filesystem.hpp>
 #include <evt/chain/block.hpp>
 #include <evt/chain/genesis_state.hpp>
@@ -39,8 +41,26 @@ class block_log_impl;
     */
 
 class block_log {
+public:
+    // `data` is the packed block as stored in log and is only valid during the callback, return false to stop
+    using raw_block_func = std::function<bool(uint32_t block_num, const std::string_view& data)>;
+
+    enum class flush_mode {
+        every_block = 0,  // flushes after each appended block
+        group,            // flushes on appending once `max_blocks` blocks are pending or `max_ms` milliseconds passed since last flush,
+                          // pending blocks stay unflushed until next append or explicit `flush`
+        background        // writes and flushes on a writer thread, appending waits when `max_blocks` blocks are not flushed
+    };
+
+    struct flush_policy {
+        flush_mode mode       = flush_mode::every_block;
+        uint32_t   max_blocks = 16;
+        uint32_t   max_ms     = 500;
+    };
+
 public:
     block_log(const fc::path& data_dir);
+    block_log(const fc::path& data_dir, const flush_policy& policy);
     block_log(block_log&& other);
     ~block_log();
 
@@ -48,6 +68,10 @@ public:
     void     flush();
     void     reset(const genesis_state& gs, const signed_block_ptr& genesis_block, uint32_t first_block_num = 1);
 
+    // reads of blocks and positions go through memory mappings and are safe to call from any thread,
+    // other methods are expected to be called from the thread appending blocks.
+    // appended blocks not flushed yet are still found by the reads, except `read_raw_blocks`
+    // which only passes the flushed ones
     std::pair<signed_block_ptr, uint64_t> read_block(uint64_t file_pos) const;
     signed_block_ptr                      read_block_by_num(uint32_t block_num) const;
     signed_block_ptr
@@ -55,6 +79,9 @@ public:
         return read_block_by_num(block_header::num_from_id(id));
     }
 
+    // passes the packed bytes of blocks in [first_num, last_num] without unpacking them, returns number of blocks passed
+    uint32_t read_raw_blocks(uint32_t first_num, uint32_t last_num, const raw_block_func& func) const;
+
     /**
           * Return offset of block in file, or block_log::npos if it does not exist.
           */
@@ -70,6 +97,10 @@ public:
 
     static fc::path repair_log(const fc::path& data_dir, uint32_t truncate_at_block = 0);
 
+    // moves blocks directory to a backup location like `repair_log`, then compresses blocks filling whole chunks
+    // into a block archive, and writes a new block log of the rest blocks continuing from the archive
+    static fc::path compress_log(const fc::path& data_dir, uint32_t blocks_per_chunk);
+
     static genesis_state extract_genesis_state(const fc::path& data_dir);
 
 private:
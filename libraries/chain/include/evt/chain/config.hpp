@@ -54,6 +54,13 @@ const static uint32_t default_global_charge_factor       = 10;
 
 const static uint32_t default_abi_serializer_max_time_ms = 15; ///< default deadline for abi serialization methods
 
+const static uint16_t default_signature_recovery_threads = 2;   ///< worker threads recovering signatures ahead of apply
+const static uint16_t default_snapshot_threads           = 4;   ///< worker threads scanning token database sections of snapshots
+const static uint32_t default_replay_recovery_ahead      = 16;  ///< blocks read ahead from block log for recovery during replay
+const static uint32_t default_replay_fast_flush_blocks   = 1000;  ///< blocks whose token writes are persisted in one batch with --replay-fast
+const static uint32_t default_auth_cache_size            = 64 * 1024;  ///< max memoized authority check results, 0 to disable
+const static uint32_t default_holder_cache_size          = 1024 * 1024;  ///< max holders indexed for passive bonus distributions, 0 to disable
+
 /**
  *  The number of sequential blocks produced by a single producer
  */
@@ -415,9 +415,14 @@ struct abi_to_variant {
         auto        type = ctx.exec_ctx.get_acttype_name(act.name);
         if(!type.empty()) {
             try {
-                binary_to_variant_context _ctx(ctx, type);
-                _ctx.short_path = true;  // Just to be safe while avoiding the complexity of threading an override boolean all over the place
-                mvo("data", self._binary_to_variant(type, act.data, _ctx));
+                auto data = fc::variant();
+                // built-in actions are converted through their reflected types, ABI is only the fallback
+                if(!ctx.exec_ctx.binary_to_variant(act.name, act.data, data)) {
+                    binary_to_variant_context _ctx(ctx, type);
+                    _ctx.short_path = true;  // Just to be safe while avoiding the complexity of threading an override boolean all over the place
+                    data = self._binary_to_variant(type, act.data, _ctx);
+                }
+                mvo("data", std::move(data));
                 mvo("hex_data", act.data);
             }
             catch(...) {
@@ -572,9 +577,11 @@ struct abi_from_variant {
                 const auto& self = ctx.self;
                 auto        type = ctx.exec_ctx.get_acttype_name(act.name);
                 if(!type.empty()) {
-                    auto _ctx = variant_to_binary_context(ctx, type);
-                    _ctx.short_path  = true;  // Just to be safe while avoiding the complexity of threading an override boolean all over the place
-                    act.data         = self._variant_to_binary(type, data, _ctx);
+                    if(!ctx.exec_ctx.variant_to_binary(act.name, data, act.data)) {
+                        auto _ctx = variant_to_binary_context(ctx, type);
+                        _ctx.short_path = true;  // Just to be safe while avoiding the complexity of threading an override boolean all over the place
+                        act.data        = self._variant_to_binary(type, data, _ctx);
+                    }
                     valid_empty_data = act.data.empty();
                 }
             }
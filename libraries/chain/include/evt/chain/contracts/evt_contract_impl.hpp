@@ -19,12 +19,14 @@
 #include <fc/crypto/ripemd160.hpp>
 #include <fc/crypto/city.hpp>
 
+#include <evt/chain/authority_cache.hpp>
 #include <evt/chain/apply_context.hpp>
 #include <evt/chain/token_database.hpp>
 #include <evt/chain/token_database_cache.hpp>
 #include <evt/chain/transaction_context.hpp>
 #include <evt/chain/global_property_object.hpp>
 #include <evt/chain/dense_hash.hpp>
+#include <evt/chain/holder_dist_cache.hpp>
 #include <evt/chain/contracts/types.hpp>
 #include <evt/chain/contracts/evt_link.hpp>
 #include <evt/chain/contracts/evt_link_object.hpp>
@@ -213,10 +215,9 @@ get_db_prefix<token_def>(const token_def& v) {
         tokendb_cache.put_token(TYPE, action_op::put, get_db_prefix(VALUE), get_db_key(VALUE), VALUE); \
     }
 
-#define PUT_DB_ASSET(ADDR, VALUE)                                     \
-    {                                                                 \
-        auto dv = make_db_value(VALUE);                               \
-        tokendb.put_asset(ADDR, VALUE.sym.id(), dv.as_string_view()); \
+#define PUT_DB_ASSET(ADDR, VALUE)                             \
+    {                                                         \
+        tokendb_cache.put_asset(ADDR, VALUE.sym.id(), VALUE); \
     }
 
 #define READ_DB_TOKEN(TYPE, PREFIX, KEY, VPTR, EXCEPTION, FORMAT, ...)      \
@@ -247,40 +248,40 @@ get_db_prefix<token_def>(const token_def& v) {
 
 #define READ_DB_ASSET(ADDR, SYM, VALUEREF)                                                              \
     try {                                                                                               \
-        auto str = std::string();                                                                       \
-        tokendb.read_asset(ADDR, SYM.id(), str);                                                        \
-                                                                                                        \
-        extract_db_value(str, VALUEREF);                                                                \
+        using vtype = std::decay_t<decltype(VALUEREF)>;                                                 \
+        VALUEREF = *tokendb_cache.template read_asset<vtype>(ADDR, SYM.id());                           \
     }                                                                                                   \
     catch(token_database_exception&) {                                                                  \
         EVT_THROW2(balance_exception, "There's no balance left in {} with sym id: {}", ADDR, SYM.id()); \
     }                                                                                                   \
     CHECK_SYM(VALUEREF, SYM);
 
-#define READ_DB_ASSET_NO_THROW(ADDR, SYM, VALUEREF)                         \
-    {                                                                       \
-        auto str = std::string();                                           \
-        if(!tokendb.read_asset(ADDR, SYM.id(), str, true /* no throw */)) { \
-            VALUEREF = MAKE_PROPERTY(0, SYM);                               \
-            context.add_new_ft_holder(                                      \
-                ft_holder { .addr = ADDR, .sym_id = SYM.id() });            \
-        }                                                                   \
-        else {                                                              \
-            extract_db_value(str, VALUEREF);                                \
-            CHECK_SYM(VALUEREF, SYM);                                       \
-        }                                                                   \
-    }
-
-#define READ_DB_ASSET_NO_THROW_NO_NEW(ADDR, SYM, VALUEREF)                  \
-    {                                                                       \
-        auto str = std::string();                                           \
-        if(!tokendb.read_asset(ADDR, SYM.id(), str, true /* no throw */)) { \
-            VALUEREF = MAKE_PROPERTY(0, SYM);                               \
-        }                                                                   \
-        else {                                                              \
-            extract_db_value(str, VALUEREF);                                \
-            CHECK_SYM(VALUEREF, SYM);                                       \
-        }                                                                   \
+#define READ_DB_ASSET_NO_THROW(ADDR, SYM, VALUEREF)                                                  \
+    {                                                                                                \
+        using vtype = std::decay_t<decltype(VALUEREF)>;                                              \
+        auto vptr   = tokendb_cache.template read_asset<vtype>(ADDR, SYM.id(), true /* no throw */); \
+        if(vptr == nullptr) {                                                                        \
+            VALUEREF = MAKE_PROPERTY(0, SYM);                                                        \
+            context.add_new_ft_holder(                                                               \
+                ft_holder { .addr = ADDR, .sym_id = SYM.id() });                                     \
+        }                                                                                            \
+        else {                                                                                       \
+            VALUEREF = *vptr;                                                                        \
+            CHECK_SYM(VALUEREF, SYM);                                                                \
+        }                                                                                            \
+    }
+
+#define READ_DB_ASSET_NO_THROW_NO_NEW(ADDR, SYM, VALUEREF)                                           \
+    {                                                                                                \
+        using vtype = std::decay_t<decltype(VALUEREF)>;                                              \
+        auto vptr   = tokendb_cache.template read_asset<vtype>(ADDR, SYM.id(), true /* no throw */); \
+        if(vptr == nullptr) {                                                                        \
+            VALUEREF = MAKE_PROPERTY(0, SYM);                                                        \
+        }                                                                                            \
+        else {                                                                                       \
+            VALUEREF = *vptr;                                                                        \
+            CHECK_SYM(VALUEREF, SYM);                                                                \
+        }                                                                                            \
     }
 
 #define DECLARE_TOKEN_DB()                       \
@@ -509,6 +510,7 @@ EVT_ACTION_IMPL_BEGIN(updategroup) {
 
         *group = ugact.group;
         UPD_DB_TOKEN(token_type::group, *group);
+        context.control.auth_cache().invalidate();  // memoized results of old permissions are stale now
     }
     EVT_CAPTURE_AND_RETHROW(tx_apply_exception);
 }
@@ -563,6 +565,7 @@ EVT_ACTION_IMPL_BEGIN(updatedomain) {
         }
 
         UPD_DB_TOKEN(token_type::domain, *domain);
+        context.control.auth_cache().invalidate();  // memoized results of old permissions are stale now
     }
     EVT_CAPTURE_AND_RETHROW(tx_apply_exception);
 }
@@ -832,6 +835,7 @@ EVT_ACTION_IMPL_BEGIN(updfungible) {
         }
 
         UPD_DB_TOKEN(token_type::fungible, *fungible);
+        context.control.auth_cache().invalidate();  // memoized results of old permissions are stale now
     }
     EVT_CAPTURE_AND_RETHROW(tx_apply_exception);
 }
@@ -1458,6 +1462,7 @@ EVT_ACTION_IMPL_BEGIN(everipay) {
             .trx_id    = context.trx_context.trx_meta->id
         };
         ADD_DB_TOKEN(token_type::evtlink, link_obj);
+        context.control.on_applied_everipay(link_obj);
 
         auto keys = link.restore_keys();
         EVT_ASSERT(keys.size() == 1, everipay_exception, "There're more than one signature on everiPay link, which is invalid");
@@ -2148,61 +2153,6 @@ EVT_ACTION_IMPL_END()
 
 namespace internal {
 
-struct pubkey_hasher {
-    size_t
-    operator()(const std::string& key) const {
-        return fc::city_hash_size_t(key.data(), key.size());
-    }
-};
-
-template<typename T>
-struct no_hasher {
-    size_t
-    operator()(const T v) const {
-        static_assert(sizeof(v) <= sizeof(size_t));
-        return (size_t)v;
-    }
-};
-
-// it's a very special map that holds the hash value as key
-// so the hasher method simplely return the key directly
-// key is the hash(pubkey) and value is the amount of asset
-using holder_slim_map = google::dense_hash_map<uint32_t, int64_t, no_hasher<uint32_t>>;
-// map for storing the pubkeys of collision
-using holder_coll_map = std::unordered_map<std::string, int64_t, pubkey_hasher>;
-
-struct holder_dist {
-public:
-    holder_dist() {
-        slim.set_empty_key(0);
-    }
-
-public:
-    symbol_id_type  sym_id;
-    holder_slim_map slim;
-    holder_coll_map coll;
-    int64_t         total;
-};
-
-void
-build_holder_dist(const token_database& tokendb, symbol sym, holder_dist& dist) {
-    dist.sym_id = sym.id();
-    tokendb.read_assets_range(sym.id(), 0, [&dist](auto& k, auto&& v) {
-        property prop;
-        extract_db_value(v, prop);
-
-        auto h  = fc::city_hash32(k.data(), k.size());
-        auto it = dist.slim.emplace(h, prop.amount);
-        if(it.second == false) {
-            // meet collision
-            dist.coll.emplace(std::string(k.data(), k.size()), prop.amount);
-        }
-        dist.total += prop.amount;
-
-        return true;
-    });
-};
-
 using holder_dists = small_vector<holder_dist, 4>;
 
 struct bonusdist {
@@ -2268,9 +2218,8 @@ EVT_ACTION_IMPL_BEGIN(distpsvbonus) {
             }  // switch
 
             if(ftrev.has_value()) {
-                auto dist = holder_dist();
-                build_holder_dist(tokendb, ftrev->threshold.sym(), dist);
-                bd.holders.emplace_back(std::move(dist));
+                // balances are synced incrementally since last distribution instead of a full scan
+                bd.holders.emplace_back(context.control.holder_cache().get(ftrev->threshold.sym().id()));
             }
         }
 
@@ -2295,5 +2244,4 @@ EVT_ACTION_IMPL_END()
 
 }}} // namespace evt::chain::contracts
 
-FC_REFLECT(evt::chain::contracts::internal::holder_dist, (sym_id)(slim)(coll)(total));
 FC_REFLECT(evt::chain::contracts::internal::bonusdist, (created_at)(created_index)(holders)(deadline)(final_receiver));
@@ -0,0 +1,258 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+#pragma once
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fc/variant.hpp>
+#include <fc/variant_object.hpp>
+#include <fc/variant_wrapper.hpp>
+#include <fc/io/enum_type.hpp>
+#include <fc/reflect/variant.hpp>
+
+#include <evt/chain/block_timestamp.hpp>
+#include <evt/chain/exceptions.hpp>
+#include <evt/chain/types.hpp>
+#include <evt/chain/contracts/types.hpp>
+
+namespace evt { namespace chain { namespace contracts {
+
+/**
+ * Converts reflected types from and to variants exactly like abi_serializer does with the evt ABI,
+ * but walks the C++ types at compile time instead of interpreting the ABI at runtime.
+ *
+ * It differs from plain fc::to_variant / fc::from_variant where ABI does:
+ * empty optional fields are kept as null, missing non-optional fields are rejected and
+ * types of variants and enums must be given by names.
+ */
+namespace reflected_abi {
+
+// types converted by fc as a whole, they're the built-in types of abi_serializer
+template <typename T>
+struct is_builtin : std::is_arithmetic<T> {};
+
+template <> struct is_builtin<std::string> : std::true_type {};
+template <> struct is_builtin<bytes> : std::true_type {};
+template <> struct is_builtin<public_key_type> : std::true_type {};
+template <> struct is_builtin<signature_type> : std::true_type {};
+template <> struct is_builtin<address> : std::true_type {};
+template <> struct is_builtin<symbol> : std::true_type {};
+template <> struct is_builtin<asset> : std::true_type {};
+template <> struct is_builtin<percent_type> : std::true_type {};
+template <> struct is_builtin<percent_slim> : std::true_type {};
+template <> struct is_builtin<fc::time_point> : std::true_type {};
+template <> struct is_builtin<fc::time_point_sec> : std::true_type {};
+template <> struct is_builtin<block_timestamp_type> : std::true_type {};
+template <> struct is_builtin<checksum160_type> : std::true_type {};
+template <> struct is_builtin<checksum256_type> : std::true_type {};
+template <> struct is_builtin<checksum512_type> : std::true_type {};
+template <> struct is_builtin<name> : std::true_type {};
+template <> struct is_builtin<name128> : std::true_type {};
+template <> struct is_builtin<group> : std::true_type {};
+template <> struct is_builtin<authorizer_ref> : std::true_type {};
+template <> struct is_builtin<producer_schedule_type> : std::true_type {};
+template <> struct is_builtin<extensions_type> : std::true_type {};
+template <> struct is_builtin<evt_link> : std::true_type {};
+
+template <typename T>
+constexpr bool is_struct_v = fc::reflector<T>::is_defined::value && !fc::reflector<T>::is_enum::value && !is_builtin<T>::value;
+
+template <typename T>
+struct is_optional : std::false_type {};
+
+template <typename T>
+struct is_optional<std::optional<T>> : std::true_type {};
+
+template <typename T, typename = void>
+struct serializer {
+    static void
+    to_variant(const T& o, fc::variant& v) {
+        v = fc::variant(o);
+    }
+
+    static void
+    from_variant(const fc::variant& v, T& o) {
+        fc::from_variant(v, o);
+    }
+};
+
+template <typename T>
+struct serializer<std::optional<T>> {
+    static void
+    to_variant(const std::optional<T>& o, fc::variant& v) {
+        if(o.has_value()) {
+            serializer<T>::to_variant(*o, v);
+        }
+        else {
+            v = fc::variant();
+        }
+    }
+
+    static void
+    from_variant(const fc::variant& v, std::optional<T>& o) {
+        if(v.is_null()) {
+            o.reset();
+            return;
+        }
+        o.emplace();
+        serializer<T>::from_variant(v, *o);
+    }
+};
+
+template <typename Vec>
+struct array_serializer {
+    static void
+    to_variant(const Vec& o, fc::variant& v) {
+        auto vars = fc::variants(o.size());
+        for(auto i = 0u; i < o.size(); i++) {
+            serializer<typename Vec::value_type>::to_variant(o[i], vars[i]);
+        }
+        v = fc::variant(std::move(vars));
+    }
+
+    static void
+    from_variant(const fc::variant& v, Vec& o) {
+        auto& vars = v.get_array();
+        o.clear();
+        o.resize(vars.size());
+        for(auto i = 0u; i < vars.size(); i++) {
+            serializer<typename Vec::value_type>::from_variant(vars[i], o[i]);
+        }
+    }
+};
+
+template <typename T>
+struct serializer<std::vector<T>, std::enable_if_t<!is_builtin<std::vector<T>>::value>>
+    : array_serializer<std::vector<T>> {};
+
+template <typename T, size_t N>
+struct serializer<small_vector<T, N>, std::enable_if_t<!is_builtin<small_vector<T, N>>::value>>
+    : array_serializer<small_vector<T, N>> {};
+
+template <typename IntType, typename EnumType>
+struct serializer<fc::enum_type<IntType, EnumType>> {
+    static void
+    to_variant(const fc::enum_type<IntType, EnumType>& o, fc::variant& v) {
+        fc::to_variant(o, v);
+    }
+
+    static void
+    from_variant(const fc::variant& v, fc::enum_type<IntType, EnumType>& o) {
+        EVT_ASSERT2(v.is_string(), pack_exception, "Value of enum should be string");
+        fc::from_variant(v, o);
+    }
+};
+
+template <typename ENUM, typename... ARGS>
+struct serializer<fc::variant_wrapper<ENUM, ARGS...>> {
+    static void
+    to_variant(const fc::variant_wrapper<ENUM, ARGS...>& o, fc::variant& v) {
+        auto mvo  = fc::mutable_variant_object();
+        auto type = fc::variant();
+        auto data = fc::variant();
+        fc::to_variant(o.type(), type);
+        std::visit([&data](auto& obj) {
+            serializer<std::decay_t<decltype(obj)>>::to_variant(obj, data);
+        }, o.value_);
+
+        mvo("type", std::move(type));
+        mvo("data", std::move(data));
+        v = fc::variant(std::move(mvo));
+    }
+
+    static void
+    from_variant(const fc::variant& v, fc::variant_wrapper<ENUM, ARGS...>& o) {
+        auto& vo = v.get_object();
+        EVT_ASSERT2(vo.contains("type") && vo["type"].is_string(), pack_exception, "Missing or invalid field 'type' of variant");
+        EVT_ASSERT2(vo.contains("data"), pack_exception, "Missing field 'data' of variant");
+
+        auto type = vo["type"].as<ENUM>();
+        EVT_ASSERT2((size_t)type < sizeof...(ARGS), pack_exception, "Invalid 'type' value of variant");
+
+        auto range = boost::hana::range_c<size_t, 0, sizeof...(ARGS)>;
+        boost::hana::for_each(range, [&](auto i) {
+            if((size_t)type == i()) {
+                using obj_t = std::variant_alternative_t<i(), decltype(o.value_)>;
+                auto  obj   = obj_t{};
+
+                serializer<obj_t>::from_variant(vo["data"], obj);
+                o.value_.template emplace<obj_t>(std::move(obj));
+            }
+        });
+    }
+};
+
+template <typename T>
+class to_variant_visitor {
+public:
+    to_variant_visitor(fc::mutable_variant_object& mvo, const T& v)
+        : mvo(mvo)
+        , val(v) {}
+
+    template <typename Member, class Class, Member(Class::*member)>
+    void
+    operator()(const char* name) const {
+        auto v = fc::variant();
+        serializer<Member>::to_variant(val.*member, v);
+        mvo(name, std::move(v));
+    }
+
+private:
+    fc::mutable_variant_object& mvo;
+    const T&                    val;
+};
+
+template <typename T>
+class from_variant_visitor : public fc::reflector_init_visitor<T> {
+public:
+    from_variant_visitor(const fc::variant_object& vo, T& v)
+        : fc::reflector_init_visitor<T>(v)
+        , vo(vo) {}
+
+    template <typename Member, class Class, Member(Class::*member)>
+    void
+    operator()(const char* name) const {
+        auto it = vo.find(name);
+        if(it != vo.end()) {
+            serializer<Member>::from_variant(it->value(), this->obj.*member);
+            return;
+        }
+        EVT_ASSERT2(is_optional<Member>::value, pack_exception, "Missing field '{}' in input object", name);
+    }
+
+private:
+    const fc::variant_object& vo;
+};
+
+template <typename T>
+struct serializer<T, std::enable_if_t<is_struct_v<T>>> {
+    static void
+    to_variant(const T& o, fc::variant& v) {
+        auto mvo = fc::mutable_variant_object();
+        fc::reflector<T>::visit(to_variant_visitor<T>(mvo, o));
+        v = fc::variant(std::move(mvo));
+    }
+
+    static void
+    from_variant(const fc::variant& v, T& o) {
+        fc::reflector<T>::visit(from_variant_visitor<T>(v.get_object(), o));
+    }
+};
+
+template <typename T>
+void
+to_variant(const T& o, fc::variant& v) {
+    serializer<T>::to_variant(o, v);
+}
+
+template <typename T>
+void
+from_variant(const fc::variant& v, T& o) {
+    serializer<T>::from_variant(v, o);
+}
+
+}}}}  // namespace evt::chain::contracts::reflected_abi
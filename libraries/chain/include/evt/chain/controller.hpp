@@ -7,6 +7,7 @@
 #include <functional>
 #include <map>
 #include <boost/signals2/signal.hpp>
+#include <evt/chain/block_log.hpp>
 #include <evt/chain/block_state.hpp>
 #include <evt/chain/genesis_state.hpp>
 #include <evt/chain/token_database.hpp>
@@ -24,6 +25,8 @@ class apply_context;
 class charge_manager;
 class execution_context;
 class token_database_cache;
+class authority_cache;
+class holder_dist_cache;
 
 struct controller_impl;
 using boost::signals2::signal;
@@ -58,24 +61,31 @@ enum class validation_mode {
 class controller {
 public:
     struct config {
-        path     blocks_dir             = chain::config::default_blocks_dir_name;
-        path     state_dir              = chain::config::default_state_dir_name;
-        uint64_t state_size             = chain::config::default_state_size;
-        uint64_t state_guard_size       = chain::config::default_state_guard_size;
-        uint64_t reversible_cache_size  = chain::config::default_reversible_cache_size;
-        uint64_t reversible_guard_size  = chain::config::default_reversible_guard_size;
-        bool     read_only              = false;
-        bool     force_all_checks       = false;
-        bool     disable_replay_opts    = false;
-        bool     loadtest_mode          = false;
-        bool     charge_free_mode       = false;
-        bool     contracts_console      = false;
+        path     blocks_dir                 = chain::config::default_blocks_dir_name;
+        path     state_dir                  = chain::config::default_state_dir_name;
+        uint64_t state_size                 = chain::config::default_state_size;
+        uint64_t state_guard_size           = chain::config::default_state_guard_size;
+        uint64_t reversible_cache_size      = chain::config::default_reversible_cache_size;
+        uint64_t reversible_guard_size      = chain::config::default_reversible_guard_size;
+        bool     read_only                  = false;
+        bool     force_all_checks           = false;
+        bool     disable_replay_opts        = false;
+        bool     replay_fast                = false;
+        bool     loadtest_mode              = false;
+        bool     charge_free_mode           = false;
+        bool     contracts_console          = false;
+        uint16_t signature_recovery_threads = chain::config::default_signature_recovery_threads;
+        uint16_t snapshot_threads           = chain::config::default_snapshot_threads;
+        uint32_t auth_cache_size            = chain::config::default_auth_cache_size;
+        uint32_t holder_cache_size          = chain::config::default_holder_cache_size;
 
         std::chrono::microseconds max_serialization_time = std::chrono::milliseconds(chain::config::default_abi_serializer_max_time_ms);
 
         db_read_mode    read_mode             = db_read_mode::SPECULATIVE;
         validation_mode block_validation_mode = validation_mode::FULL;
 
+        block_log::flush_policy blog_flush_policy;
+
         flat_set<account_name> trusted_producers;
 
         token_database::config db_config;
@@ -128,10 +138,15 @@ public:
 
     void push_block(const signed_block_ptr& b);
 
+    // raises `applied_everipay`, exceptions thrown by handlers are not propagated into the action
+    void on_applied_everipay(const evt_link_object& link_obj);
+
     chainbase::database& db() const;
     fork_database& fork_db() const;
     token_database& token_db() const;
     token_database_cache& token_db_cache() const;
+    authority_cache& auth_cache() const;
+    holder_dist_cache& holder_cache() const;
 
     charge_manager get_charge_manager() const;
 
@@ -165,6 +180,9 @@ public:
 
     signed_block_ptr fetch_block_by_number(uint32_t block_num) const;
     signed_block_ptr fetch_block_by_id(block_id_type id) const;
+    uint32_t         fetch_raw_blocks(uint32_t first_num, uint32_t last_num, const block_log::raw_block_func& func) const;
+    // only reads irreversible blocks in block log, safe to call from any thread
+    signed_block_ptr fetch_irreversible_block_by_number(uint32_t block_num) const;
 
     block_state_ptr fetch_block_state_by_number(uint32_t block_num) const;
     block_state_ptr fetch_block_state_by_id(block_id_type id) const;
@@ -176,6 +194,11 @@ public:
     fc::sha256 calculate_integrity_hash() const;
     void write_snapshot(const std::shared_ptr<snapshot_writer>& snapshot) const;
 
+    // writes the small chain state part of snapshot and creates a checkpoint of token database in `checkpoint_dir`,
+    // the rest is written from the checkpoint by `write_snapshot_from_checkpoint` which is safe to call from any thread
+    void write_snapshot_checkpoint(const std::shared_ptr<snapshot_writer>& snapshot, const fc::path& checkpoint_dir) const;
+    void write_snapshot_from_checkpoint(const std::shared_ptr<snapshot_writer>& snapshot, const fc::path& checkpoint_dir) const;
+
     bool is_producing_block() const;
 
     void validate_expiration(const transaction& t) const;
@@ -193,6 +216,7 @@ public:
     bool skip_db_sessions() const;
     bool skip_db_sessions(block_status bs) const;
     bool skip_trx_checks() const;
+    bool replay_fast_mode() const;
     bool loadtest_mode() const;
     bool charge_free_mode() const;
     bool contracts_console() const;
@@ -210,6 +234,7 @@ public:
     signal<void(const transaction_metadata_ptr&)> accepted_transaction;
     signal<void(const transaction_trace_ptr&)>    applied_transaction;
     signal<void(const int&)>                      bad_alloc;
+    signal<void(const evt_link_object&)>          applied_everipay;  // transaction may still fail or pending block be aborted
 
     public_keys_set get_required_keys(const transaction& trx, const public_keys_set& candidate_keys) const;
     public_keys_set get_suspend_required_keys(const transaction& trx, const public_keys_set& candidate_keys) const;
@@ -233,9 +258,14 @@ FC_REFLECT(evt::chain::controller::config,
            (read_only)
            (force_all_checks)
            (disable_replay_opts)
+           (replay_fast)
            (loadtest_mode)
            (charge_free_mode)
            (contracts_console)
+           (signature_recovery_threads)
+           (snapshot_threads)
+           (auth_cache_size)
+           (holder_cache_size)
            (trusted_producers)
            (db_config)
            (genesis)
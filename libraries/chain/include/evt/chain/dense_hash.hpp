@@ -1,3 +1,4 @@
+#pragma once
 #include <type_traits>
 #include <sparsehash/dense_hash_map>
 #include <sparsehash/dense_hash_set>
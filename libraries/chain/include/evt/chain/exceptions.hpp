@@ -314,6 +314,7 @@ FC_DECLARE_DERIVED_EXCEPTION( missing_chain_plugin_exception,        plugin_exce
 FC_DECLARE_DERIVED_EXCEPTION( missing_producer_api_plugin_exception, plugin_exception, 3130009, "Missing Producer API Plugin" );
 FC_DECLARE_DERIVED_EXCEPTION( missing_postgres_plugin_exception,     plugin_exception, 3130010, "Missing postgres Plugin" );
 FC_DECLARE_DERIVED_EXCEPTION( exceed_query_limit_exception,          plugin_exception, 3130011, "Exceed max query limit" );
+FC_DECLARE_DERIVED_EXCEPTION( invalid_query_cursor_exception,        plugin_exception, 3130012, "Invalid query cursor" );
 
 FC_DECLARE_DERIVED_EXCEPTION( wallet_exception,                  chain_exception,  3140000, "wallet exception" );
 FC_DECLARE_DERIVED_EXCEPTION( wallet_exist_exception,            wallet_exception, 3140001, "Wallet already exists" );
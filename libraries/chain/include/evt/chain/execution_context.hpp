@@ -29,6 +29,11 @@ public:
     virtual int get_max_version(name act) const = 0;
     virtual std::vector<action_ver> get_current_actions() const = 0;
 
+    // convert data of built-in actions through their reflected types of current version instead of ABI,
+    // return false when `act` is unknown or conversion fails and it should be left to ABI
+    virtual bool binary_to_variant(name act, const bytes& data, fc::variant& var) const = 0;
+    virtual bool variant_to_binary(name act, const fc::variant& var, bytes& data) const = 0;
+
 public:
     void set_versions(const std::vector<action_ver>& acts);
 };
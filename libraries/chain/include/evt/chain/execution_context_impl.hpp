@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <functional>
 #include <string>
 #include <type_traits>
@@ -16,11 +17,42 @@
 #include <evt/chain/exceptions.hpp>
 #include <evt/chain/types.hpp>
 #include <evt/chain/contracts/types.hpp>
+#include <evt/chain/contracts/reflected_abi.hpp>
 
 namespace hana = boost::hana;
 
 namespace evt { namespace chain {
 
+namespace internal {
+
+template<uint64_t N>
+struct reflected_binary_to_variant {
+    template<typename T>
+    static void
+    invoke(const bytes& data, fc::variant& var) {
+        auto ds  = fc::datastream<const char*>(data.data(), data.size());
+        auto obj = T();
+        fc::raw::unpack(ds, obj);
+        EVT_ASSERT2(ds.remaining() == 0, unpack_exception, "Binary buffer is not EOF after unpack variable, remaining: {} bytes.", ds.remaining());
+
+        contracts::reflected_abi::to_variant(obj, var);
+    }
+};
+
+template<uint64_t N>
+struct reflected_variant_to_binary {
+    template<typename T>
+    static void
+    invoke(const fc::variant& var, bytes& data) {
+        auto obj = T();
+        contracts::reflected_abi::from_variant(var, obj);
+
+        data = fc::raw::pack(obj);
+    }
+};
+
+}  // namespace internal
+
 template<typename ... ACTTYPE>
 class execution_context_impl : public execution_context {
 public:
@@ -35,7 +67,7 @@ public:
             auto i = index_of(act);
             type_names_[i].emplace_back(decltype(+act)::type::get_type_name());
             assert(type_names_[i].size() == decltype(+act)::type::get_version());
-            curr_vers_[i] = 1;  // ver starts from 1
+            curr_vers_[i].store(1, std::memory_order_relaxed);  // ver starts from 1
         });
 
         act_names_arr_ = hana::unpack(act_names_, [](auto ...i) {
@@ -55,6 +87,11 @@ public:
         return std::distance(std::cbegin(arr), it);
     }
 
+    static constexpr int
+    actions_count() {
+        return hana::length(act_names_);
+    }
+
     template<typename T>
     constexpr int
     index_of() const {
@@ -67,13 +104,13 @@ public:
     int
     set_version(name act, int newver) override {
         auto actindex = index_of(act);
-        auto cver     = curr_vers_[actindex];
+        auto cver     = get_curr_ver(actindex);
         auto mver     = type_names_[actindex].size();
 
         EVT_ASSERT2(newver > cver && newver <= (int)mver, action_version_exception, "New version should be in range ({},{}]", cver, mver);
 
-        auto old_ver         = cver;
-        curr_vers_[actindex] = newver;
+        auto old_ver = cver;
+        curr_vers_[actindex].store(newver, std::memory_order_relaxed);
 
         return old_ver;
     }
@@ -81,11 +118,11 @@ public:
     int
     set_version_unsafe(name act, int newver) override {
         auto actindex = index_of(act);
-        auto cver     = curr_vers_[actindex];
+        auto cver     = get_curr_ver(actindex);
         auto mver     = type_names_[actindex].size() - 1;
 
-        auto old_ver         = cver;
-        curr_vers_[actindex] = newver;
+        auto old_ver = cver;
+        curr_vers_[actindex].store(newver, std::memory_order_relaxed);
 
         return old_ver;
     }
@@ -106,50 +143,53 @@ public:
         return (int)type_names_[index_of(act)].size();
     }
 
+    bool
+    binary_to_variant(name act, const bytes& data, fc::variant& var) const override {
+        auto actindex = find_index(act);
+        if(actindex < 0) {
+            return false;
+        }
+        try {
+            invoke<internal::reflected_binary_to_variant, void>(actindex, data, var);
+            return true;
+        }
+        catch(...) {
+            // ABI is used to report the error
+            return false;
+        }
+    }
+
+    bool
+    variant_to_binary(name act, const fc::variant& var, bytes& data) const override {
+        auto actindex = find_index(act);
+        if(actindex < 0) {
+            return false;
+        }
+        try {
+            invoke<internal::reflected_variant_to_binary, void>(actindex, var, data);
+            return true;
+        }
+        catch(...) {
+            // ABI also accepts structs given by arrays, and is used to report the error
+            return false;
+        }
+    }
+
     template <template<uint64_t> typename Invoker, typename RType, typename ... Args>
     RType
     invoke(int actindex, Args&&... args) const {
-        using opt_type = std::conditional_t<std::is_void<RType>::value, int, RType>;
-
-        auto fn = [&](auto i) -> std::optional<opt_type> {
-            auto name  = act_names_[i];
-            auto vers  = hana::filter(act_types_,
-                [&](auto& t) { return hana::equal(name, hana::ulong_c<decltype(+t)::type::get_action_name().value>); });
-            auto cver = curr_vers_[i];
-
-            static_assert(hana::length(vers)() > hana::size_c<0>(), "empty version actions!");
-
-            auto result = std::optional<opt_type>();
-            hana::for_each(vers, [&, cver](auto v) {
-                using ty = typename decltype(+v)::type;
-
-                constexpr auto n = ty::get_action_name().value;
-                if(ty::get_version() == cver) {
-                    if constexpr (std::is_void<RType>::value) {
-                        Invoker<n>::template invoke<ty>(std::forward<Args>(args)...);
-                        result = 1;
-                    }
-                    else {
-                        result = Invoker<n>::template invoke<ty>(std::forward<Args>(args)...);
-                    }
-                }
-            });
-
-            return result;
-        };
+        constexpr auto& table = invoke_table<Invoker, RType, Args...>::value;
 
-        auto range  = hana::make_range(hana::int_c<0>, hana::length(act_names_));
-        auto result = std::optional<opt_type>();
-        hana::for_each(range, [&](auto i) {
-            if(i() == actindex) {
-                result = fn(i);
+        auto fn = (invoke_func<RType, Args...>)nullptr;
+        if(actindex >= 0 && actindex < (int)table.size()) {
+            auto cver = get_curr_ver(actindex);
+            if(cver >= 1 && cver <= max_version_) {
+                fn = table[actindex][cver - 1];
             }
-        });
-
-        EVT_ASSERT(result.has_value(), action_index_exception, "Invalid action index: ${act}", ("act", actindex));
-        if constexpr (!std::is_void<RType>::value) {
-            return *result;
         }
+
+        EVT_ASSERT(fn != nullptr, action_index_exception, "Invalid action index: ${act}", ("act", actindex));
+        return fn(std::forward<Args>(args)...);
     }
 
     template <typename T, typename Func>
@@ -161,7 +201,7 @@ public:
         auto name  = act_names_[i.value()];
         auto vers  = hana::filter(act_types_,
             [&](auto& t) { return hana::equal(name, hana::ulong_c<decltype(+t)::type::get_action_name().value>); });
-        auto cver = curr_vers_[i.value()];
+        auto cver = get_curr_ver(i.value());
 
         static_assert(hana::length(vers)() > hana::size_c<0>(), "empty version actions!");
 
@@ -181,8 +221,8 @@ public:
         for(auto i = 0u; i < act_names_arr_.size(); i++) {
             acts.emplace_back(action_ver {
                 .act  = name(act_names_arr_[i]),
-                .ver  = curr_vers_[i],
-                .type = type_names_[i][curr_vers_[i]]
+                .ver  = get_curr_ver(i),
+                .type = type_names_[i][get_curr_ver(i)]
             });
         }
 
@@ -192,15 +232,56 @@ public:
 private:
     int
     get_curr_ver(int index) const {
-        return curr_vers_[index];
+        return curr_vers_[index].load(std::memory_order_relaxed);
+    }
+
+    // same as index_of but returns -1 for unknown actions
+    int
+    find_index(name act) const {
+        auto& arr = act_names_arr_;
+        auto it   = std::lower_bound(std::cbegin(arr), std::cend(arr), act.value);
+        if(it == std::cend(arr) || *it != act.value) {
+            return -1;
+        }
+        return std::distance(std::cbegin(arr), it);
+    }
+
+    template <typename RType, typename ... Args>
+    using invoke_func = RType (*)(Args&&...);
+
+    template <template<uint64_t> typename Invoker, typename RType, typename T, typename ... Args>
+    static RType
+    invoke_one(Args&&... args) {
+        return Invoker<T::get_action_name().value>::template invoke<T>(std::forward<Args>(args)...);
     }
 
+    // table of invokers indexed by [actindex][version - 1], built at compile time
+    // entries are nullptr for versions not defined by that action
+    template <template<uint64_t> typename Invoker, typename RType, typename ... Args>
+    struct invoke_table {
+        static constexpr auto
+        make() {
+            auto table = std::array<std::array<invoke_func<RType, Args...>, max_version_>, hana::length(act_names_)>{};
+            hana::for_each(act_types_, [&](auto t) {
+                using ty = typename decltype(t)::type;
+
+                constexpr auto i = hana::index_if(act_names_, hana::equal.to(hana::ulong_c<ty::get_action_name().value>)).value();
+                table[i][ty::get_version() - 1] = &invoke_one<Invoker, RType, ty, Args...>;
+            });
+            return table;
+        }
+
+        static constexpr auto value = make();
+    };
+
 private:
     static constexpr auto act_types_ = hana::make_tuple(hana::type_c<ACTTYPE>...);
     static constexpr auto act_names_ = hana::sort(hana::unique(hana::transform(act_types_, [](auto& a) { return hana::ulong_c<decltype(+a)::type::get_action_name().value>; })));
+    static constexpr auto max_version_ = std::max({ ACTTYPE::get_version()... });
 
 private:
-    std::array<int, hana::length(act_names_)>                          curr_vers_;
+    // versions are updated on main thread while blocks and abi calls are serialized on http threads
+    std::array<std::atomic<int>, hana::length(act_names_)>             curr_vers_;
     std::array<uint64_t, hana::length(act_names_)>                     act_names_arr_;
     std::array<small_vector<std::string, 4>, hana::length(act_names_)> type_names_;
 };
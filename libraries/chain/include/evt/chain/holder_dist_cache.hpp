@@ -0,0 +1,302 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/signals2/connection.hpp>
+#include <fc/crypto/city.hpp>
+#include <rocksdb/slice.h>
+#include <evt/chain/dense_hash.hpp>
+#include <evt/chain/token_database.hpp>
+#include <evt/chain/contracts/types.hpp>
+
+namespace evt { namespace chain {
+
+struct pubkey_hasher {
+    size_t
+    operator()(const std::string& key) const {
+        return fc::city_hash_size_t(key.data(), key.size());
+    }
+};
+
+template<typename T>
+struct no_hasher {
+    size_t
+    operator()(const T v) const {
+        static_assert(sizeof(v) <= sizeof(size_t));
+        return (size_t)v;
+    }
+};
+
+// it's a very special map that holds the hash value as key
+// so the hasher method simplely return the key directly
+// key is the hash(pubkey) and value is the amount of asset
+using holder_slim_map = google::dense_hash_map<uint32_t, int64_t, no_hasher<uint32_t>>;
+// map for storing the pubkeys of collision
+using holder_coll_map = std::unordered_map<std::string, int64_t, pubkey_hasher>;
+
+struct holder_dist {
+public:
+    holder_dist() {
+        slim.set_empty_key(kEmptyHash);
+    }
+
+public:
+    // hash reserved by slim map, holders with it are stored in coll map
+    static constexpr uint32_t kEmptyHash = 0;
+
+public:
+    symbol_id_type  sym_id = 0;
+    holder_slim_map slim;
+    holder_coll_map coll;
+    int64_t         total = 0;
+};
+
+// holders must be added in key order, the first one of colliding holders takes the slim entry
+// so that the serialized distribution only depends on the balances
+inline void
+add_holder(holder_dist& dist, const std::string_view& key, int64_t amount) {
+    auto h = fc::city_hash32(key.data(), key.size());
+    if(h == holder_dist::kEmptyHash || !dist.slim.emplace(h, amount).second) {
+        // meet collision
+        dist.coll.emplace(std::string(key), amount);
+    }
+    dist.total += amount;
+}
+
+inline holder_dist
+build_holder_dist(const token_database& tokendb, symbol_id_type sym_id) {
+    auto dist   = holder_dist();
+    dist.sym_id = sym_id;
+    tokendb.scan_assets_range(sym_id, std::string_view(), [&dist](auto& k, auto& v) {
+        auto prop = contracts::property();
+        extract_db_value(v, prop);
+
+        add_holder(dist, k, prop.amount);
+        return true;
+    });
+    return dist;
+}
+
+/**
+ * Balances of holders of fungible symbols, maintained incrementally for building distributions.
+ *
+ * Balances of a symbol are loaded by scanning all its holders the first time its distribution is requested.
+ * Afterwards holders written or rolled back in token database are only recorded as changed,
+ * and the next request reads just these holders again before building the distribution from the balances.
+ * Distribution is always built from scratch in key order, so it's the same as the one built by scanning.
+ *
+ * Each indexed holder takes 48 bytes and each changed holder a set node until next request.
+ * At most `max_holders` holders are indexed, least recently requested symbols are evicted beyond that,
+ * and a symbol is dropped when more of its holders are changed than indexed as rescanning is cheaper then.
+ */
+class holder_dist_cache : boost::noncopyable {
+public:
+    struct stats {
+        uint64_t builds;
+        uint64_t syncs;
+        uint64_t synced_holders;
+        uint64_t evictions;
+        uint64_t symbols;
+        uint64_t holders;
+    };
+
+public:
+    holder_dist_cache(token_database& db, size_t max_holders)
+        : db_(db)
+        , max_holders_(max_holders) {
+        watch_db();
+    }
+
+public:
+    bool enabled() const { return max_holders_ > 0; }
+
+    // returns distribution of holders of `sym_id` reflecting current balances in token database
+    holder_dist
+    get(symbol_id_type sym_id) {
+        if(!enabled()) {
+            return build_holder_dist(db_, sym_id);
+        }
+
+        auto it = indexes_.find(sym_id);
+        if(it == indexes_.end()) {
+            it = indexes_.emplace(sym_id, sym_index()).first;
+            build(sym_id, it->second);
+            builds_++;
+        }
+        else {
+            sync(sym_id, it->second);
+            syncs_++;
+        }
+
+        auto& idx    = it->second;
+        idx.last_use = ++clock_;
+
+        auto dist   = holder_dist();
+        dist.sym_id = sym_id;
+        for(auto& h : idx.holders) {
+            add_holder(dist, std::string_view(h.key.data(), h.key.size()), h.amount);
+        }
+
+        evict();
+        return dist;
+    }
+
+    stats
+    get_stats() const {
+        return stats { builds_, syncs_, synced_holders_, evictions_, indexes_.size(), holders_ };
+    }
+
+private:
+    using holder_key = std::array<char, sizeof(fc::ecc::public_key_shim)>;
+
+    // same order as keys in token database
+    struct key_less {
+        bool
+        operator()(const holder_key& lhs, const holder_key& rhs) const {
+            return memcmp(lhs.data(), rhs.data(), lhs.size()) < 0;
+        }
+    };
+
+    struct holder {
+        holder_key key;
+        int64_t    amount;
+    };
+
+    struct sym_index {
+        std::vector<holder>            holders;  // sorted by key
+        std::set<holder_key, key_less> changed;  // keys of holders changed since last request
+        uint64_t                       last_use = 0;
+    };
+
+    static int64_t
+    read_amount(const std::string_view& v) {
+        auto prop = contracts::property();
+        extract_db_value(v, prop);
+        return prop.amount;
+    }
+
+    void
+    build(symbol_id_type sym_id, sym_index& idx) {
+        db_.scan_assets_range(sym_id, std::string_view(), [&idx](auto& k, auto& v) {
+            auto h = holder();
+            memcpy(h.key.data(), k.data(), h.key.size());
+            h.amount = read_amount(v);
+
+            idx.holders.emplace_back(h);
+            return true;
+        });
+        holders_ += idx.holders.size();
+    }
+
+    void
+    sync(symbol_id_type sym_id, sym_index& idx) {
+        if(idx.changed.empty()) {
+            return;
+        }
+
+        auto key = std::string(sizeof(sym_id), '\0');
+        auto str = std::string();
+        memcpy(key.data(), &sym_id, sizeof(sym_id));
+
+        auto holders = std::vector<holder>();
+        holders.reserve(idx.holders.size() + idx.changed.size());
+
+        // merges changed holders into the sorted holders
+        auto it = idx.holders.cbegin();
+        for(auto& k : idx.changed) {
+            while(it != idx.holders.cend() && key_less()(it->key, k)) {
+                holders.emplace_back(*it++);
+            }
+            if(it != idx.holders.cend() && it->key == k) {
+                it++;
+            }
+
+            key.resize(sizeof(sym_id));
+            key.append(k.data(), k.size());
+            if(db_.read_asset_by_key(key, str)) {
+                holders.emplace_back(holder { k, read_amount(str) });
+            }
+        }
+        holders.insert(holders.end(), it, idx.holders.cend());
+
+        holders_        = holders_ - idx.holders.size() + holders.size();
+        synced_holders_ += idx.changed.size();
+
+        idx.holders = std::move(holders);
+        idx.changed.clear();
+    }
+
+    void
+    drop(std::unordered_map<symbol_id_type, sym_index>::iterator it) {
+        holders_ -= it->second.holders.size();
+        indexes_.erase(it);
+        evictions_++;
+    }
+
+    void
+    evict() {
+        while(holders_ > max_holders_) {
+            auto it = std::min_element(indexes_.begin(), indexes_.end(), [](auto& lhs, auto& rhs) {
+                return lhs.second.last_use < rhs.second.last_use;
+            });
+            drop(it);
+        }
+    }
+
+    void
+    watch_db() {
+        auto on_changed = [this](auto& key) {
+            if(indexes_.empty() || key.size() != sizeof(symbol_id_type) + sizeof(holder_key)) {
+                return;
+            }
+
+            symbol_id_type sym_id;
+            memcpy(&sym_id, key.data(), sizeof(sym_id));
+
+            auto it = indexes_.find(sym_id);
+            if(it == indexes_.end()) {
+                return;
+            }
+
+            auto k = holder_key();
+            memcpy(k.data(), key.data() + sizeof(sym_id), k.size());
+
+            auto& idx = it->second;
+            idx.changed.emplace(k);
+            if(idx.changed.size() > idx.holders.size()) {
+                drop(it);
+            }
+        };
+        update_conn_   = db_.update_asset_value.connect(on_changed);
+        rollback_conn_ = db_.rollback_asset_value.connect(on_changed);
+    }
+
+private:
+    token_database&                               db_;
+    size_t                                        max_holders_;
+    std::unordered_map<symbol_id_type, sym_index> indexes_;
+
+    boost::signals2::scoped_connection update_conn_;
+    boost::signals2::scoped_connection rollback_conn_;
+
+    uint64_t clock_          = 0;
+    uint64_t holders_        = 0;
+    uint64_t builds_         = 0;
+    uint64_t syncs_          = 0;
+    uint64_t synced_holders_ = 0;
+    uint64_t evictions_      = 0;
+};
+
+}}  // namespace evt::chain
+
+FC_REFLECT(evt::chain::holder_dist, (sym_id)(slim)(coll)(total));
+FC_REFLECT(evt::chain::holder_dist_cache::stats, (builds)(syncs)(synced_holders)(evictions)(symbols)(holders));
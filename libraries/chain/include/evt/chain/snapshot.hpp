@@ -8,7 +8,9 @@
 #include <evt/chain/exceptions.hpp>
 #include <fc/variant_object.hpp>
 #include <boost/core/demangle.hpp>
+#include <functional>
 #include <ostream>
+#include <string_view>
 
 namespace evt { namespace chain {
 /**
@@ -167,8 +169,55 @@ struct snapshot_row_raw_writer : abstract_snapshot_row_writer {
     size_t      sz_;
 };
 
+// writes a string row without copying, same format as `snapshot_row_writer<std::string>`
+struct snapshot_row_string_writer : abstract_snapshot_row_writer {
+    explicit snapshot_row_string_writer(const std::string_view& data)
+        : data_(data) {}
+
+    template <typename DataStream>
+    void
+    write_stream(DataStream& out) const {
+        fc::raw::pack(out, fc::unsigned_int((uint32_t)data_.size()));
+        if(!data_.empty()) {
+            out.write(data_.data(), data_.size());
+        }
+    }
+
+    void
+    write(ostream_wrapper& out) const override {
+        write_stream(out);
+    }
+
+    void
+    write(fc::sha256::encoder& out) const override {
+        write_stream(out);
+    }
+
+    fc::variant
+    to_variant() const override {
+        auto var = variant();
+        var = std::string(data_);
+        return var;
+    }
+
+    std::string
+    row_type_name() const override {
+        return "string";
+    }
+
+    std::string_view data_;
+};
+
 }  // namespace detail
 
+// section rendered apart from the writer, keeps either the packed rows or only their hash
+struct snapshot_section_buffer {
+    std::string name;
+    uint64_t    row_count = 0;
+    std::string data;
+    fc::sha256  hash;
+};
+
 class snapshot_writer {
 public:
     class section_writer {
@@ -190,6 +239,11 @@ public:
             _writer.write_row(detail::snapshot_row_raw_writer(data, sz));
         }
 
+        void
+        add_string_row(const std::string_view& str) {
+            _writer.write_row(detail::snapshot_row_string_writer(str));
+        }
+
     private:
         friend class snapshot_writer;
         section_writer(snapshot_writer& writer)
@@ -213,12 +267,27 @@ public:
         write_section(detail::snapshot_section_traits<T>::section_name(), f);
     }
 
+    using section_func = std::function<void(size_t index, section_writer& section)>;
+
+    /**
+     * Writes sections `section_names` whose rows are added by `f`, they're always written in the given order.
+     * When the writer supports it, sections are rendered into buffers on `threads` threads at the same time,
+     * so `f` must be safe to be called concurrently and the source must not change meanwhile.
+     */
+    void write_sections(const std::vector<std::string>& section_names, size_t threads, const section_func& f);
+
     virtual ~snapshot_writer(){};
 
 protected:
+    enum class buffer_mode { none, data, hash };
+
     virtual void write_start_section(const std::string& section_name)              = 0;
     virtual void write_row(const detail::abstract_snapshot_row_writer& row_writer) = 0;
     virtual void write_end_section()                                               = 0;
+
+    // writers which can take sections rendered apart override these two
+    virtual buffer_mode section_buffer_mode() const { return buffer_mode::none; }
+    virtual void        write_section_buffer(snapshot_section_buffer&& buffer);
 };
 
 using snapshot_writer_ptr = std::shared_ptr<snapshot_writer>;
@@ -470,6 +539,10 @@ public:
 
     static const uint32_t magic_number = 0x30510550;
 
+protected:
+    buffer_mode section_buffer_mode() const override { return buffer_mode::data; }
+    void        write_section_buffer(snapshot_section_buffer&& buffer) override;
+
 private:
     detail::ostream_wrapper snapshot;
     std::streampos          header_pos;
@@ -510,6 +583,10 @@ private:
     std::vector<section_index> section_indexes;
 };
 
+/**
+ * Integrity hash is a tree of section hashes: the hash of the hashes of the packed rows of every section,
+ * so sections can be hashed concurrently. Names and structures of sections are not part of the hash.
+ */
 class integrity_hash_snapshot_writer : public snapshot_writer {
 public:
     explicit integrity_hash_snapshot_writer(fc::sha256::encoder& enc);
@@ -519,8 +596,13 @@ public:
     void write_end_section() override;
     void finalize();
 
+protected:
+    buffer_mode section_buffer_mode() const override { return buffer_mode::hash; }
+    void        write_section_buffer(snapshot_section_buffer&& buffer) override;
+
 private:
     fc::sha256::encoder& enc;
+    fc::sha256::encoder  section_enc;
 };
 
 }}  // namespace evt::chain
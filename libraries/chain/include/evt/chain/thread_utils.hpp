@@ -0,0 +1,29 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+#pragma once
+#include <future>
+#include <memory>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+namespace evt { namespace chain {
+
+/**
+ *  Posts `f` to `thread_pool` and returns a future of its result.
+ *  Exceptions thrown by `f` are stored in the future and rethrown by `get()`.
+ */
+template<typename F>
+auto
+async_thread_pool(boost::asio::thread_pool& thread_pool, F&& f) {
+    using result_type = decltype(f());
+
+    auto task = std::make_shared<std::packaged_task<result_type()>>(std::forward<F>(f));
+    boost::asio::post(thread_pool, [task]() {
+        (*task)();
+    });
+    return task->get_future();
+}
+
+}}  // namespace evt::chain
@@ -24,12 +24,18 @@ class Slice;
 namespace evt { namespace chain {
 
 using read_value_func = std::function<bool(const std::string_view& key, std::string&&)>;
+using read_view_func  = std::function<bool(const std::string_view& key, const std::string_view& value)>;
 
 enum class storage_profile {
     disk   = 0,
     memory = 1
 };
 
+enum class savepoint_engine {
+    snapshot = 0,  // old values are read from rocksdb snapshots when rolling back
+    undo_log = 1   // old values are captured into an in-memory undo log when writing
+};
+
 enum class token_type {
     asset = 0,
     domain,
@@ -116,7 +122,7 @@ make_db_value(const T& v) {
 
 template<typename T>
 void
-extract_db_value(const std::string& str, T& v) {
+extract_db_value(const std::string_view& str, T& v) {
     auto ds = fc::datastream<const char*>(str.data(), str.size());
     fc::raw::unpack(ds, v);
 }
@@ -126,11 +132,14 @@ using token_keys_t = small_vector<name128, 4>;
 class token_database : boost::noncopyable {
 public:
     struct config {
-        storage_profile profile           = storage_profile::disk;
-        uint32_t        block_cache_size  = 256 * 1024 * 1024; // 256M
-        uint32_t        object_cache_size = 256 * 1024 * 1024; // 256M
-        fc::path        db_path           = ::evt::chain::config::default_token_database_dir_name;
-        bool            enable_stats      = true;
+        storage_profile  profile            = storage_profile::disk;
+        uint32_t         block_cache_size   = 256 * 1024 * 1024; // 256M
+        uint32_t         object_cache_size  = 256 * 1024 * 1024; // 256M
+        fc::path         db_path            = ::evt::chain::config::default_token_database_dir_name;
+        bool             enable_stats       = true;
+        bool             tokens_write_cache = false;  // keep token writes in memory until savepoints are popped
+        savepoint_engine engine             = savepoint_engine::snapshot;
+        bool             bulk_restore       = true;   // restore snapshots by ingesting sorted sst files
     };
 
     class session {
@@ -200,6 +209,11 @@ public:
     int read_tokens_range(token_type type, const std::optional<name128>& domain, int skip, const read_value_func& func) const;
     int read_assets_range(const symbol_id_type sym_id, int skip, const read_value_func& func) const;
 
+    // zero-copy scans: key and value views are only valid during the callback
+    // `start` is an inclusive raw key (as passed to the callback) to continue from, empty for the first one
+    int scan_tokens_range(token_type type, const std::optional<name128>& domain, const std::string_view& start, const read_view_func& func) const;
+    int scan_assets_range(const symbol_id_type sym_id, const std::string_view& start, const read_view_func& func) const;
+
 public:
     void add_savepoint(int64_t seq);
     void rollback_to_latest_savepoint();
@@ -214,6 +228,21 @@ public:
 
     size_t savepoints_size() const;
 
+    void set_tokens_write_cache(bool enable);
+    bool tokens_write_cache() const;
+
+public:
+    // creates a consistent copy of current state in `dir` which can be opened as another token database,
+    // sst files are hard linked when possible and values pending in write caches are written into it when opened
+    void create_checkpoint(const fc::path& dir) const;
+
+public:
+    // while bulk loading, puts are written into sst files which are ingested into db at the end
+    // only for filling an empty database without savepoints, i.e. restoring from snapshot
+    bool bulk_load_supported() const;
+    void begin_bulk_load();
+    void end_bulk_load();
+
 public:
     std::string stats() const;
 
@@ -224,15 +253,21 @@ private:
 
 private:  // for cache usage
     std::string get_db_key(token_type type, const std::optional<name128>& domain, const name128& key);
+    std::string get_asset_key(const address& addr, const symbol_id_type sym_id);
+    int read_asset_by_key(const std::string_view& key, std::string& out) const;
     boost::signals2::signal<void(const rocksdb::Slice&)> rollback_token_value;
     boost::signals2::signal<void(const rocksdb::Slice&)> remove_token_value;
+    boost::signals2::signal<void(const rocksdb::Slice&)> rollback_asset_value;
+    boost::signals2::signal<void(const rocksdb::Slice&)> update_asset_value;
 
 private:
     std::unique_ptr<class token_database_impl> my_;
     friend class token_database_cache;
+    friend class authority_cache;
+    friend class holder_dist_cache;
     friend class token_database_impl;
 };
 
 }}  // namespace evt::chain
 
-FC_REFLECT(evt::chain::token_database::config, (profile)(block_cache_size)(object_cache_size)(db_path));
+FC_REFLECT(evt::chain::token_database::config, (profile)(block_cache_size)(object_cache_size)(db_path)(tokens_write_cache)(engine)(bulk_restore));
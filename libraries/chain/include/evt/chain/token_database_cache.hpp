@@ -144,6 +144,52 @@ public:
         }
     }
 
+    template<typename T>
+    std::unique_ptr<T, cache_deleter<T>>
+    read_asset(const address& addr, const symbol_id_type sym_id, bool no_throw = false) {
+        static_assert(std::is_class_v<T>, "T should be a class type");
+
+        auto k = db_.get_asset_key(addr, sym_id);
+        auto h = cache_->Lookup(k);
+        if(h != nullptr) {
+            auto entry = (cache_entry<T>*)cache_->Value(h);
+            EVT_ASSERT2(entry->ti == boost::typeindex::type_id<T>(), token_database_cache_exception,
+                "Types are not matched between cache({}) and query({})", entry->ti.pretty_name(), boost::typeindex::type_id<T>().pretty_name());
+            return std::unique_ptr<T, cache_deleter<T>>(&entry->data, cache_deleter<T>(this, h));
+        }
+
+        auto str = std::string();
+        auto r   = db_.read_asset(addr, sym_id, str, no_throw);
+        if(no_throw && !r) {
+            return nullptr;
+        }
+
+        auto entry = new cache_entry<T>();
+        extract_db_value(str, entry->data);
+
+        auto s = cache_->Insert(k, (void*)entry, str.size(),
+            [](auto& ck, auto cv) { delete (cache_entry<T>*)cv; }, &h);
+        FC_ASSERT(s == rocksdb::Status::OK());
+
+        return std::unique_ptr<T, cache_deleter<T>>(&entry->data, cache_deleter<T>(this, h));
+    }
+
+    template<typename T>
+    void
+    put_asset(const address& addr, const symbol_id_type sym_id, const T& data) {
+        static_assert(std::is_class_v<T>, "T should be a class type");
+
+        auto v = make_db_value(data);
+        // token database drops the stale entry of this key before writing
+        db_.put_asset(addr, sym_id, v.as_string_view());
+
+        auto k     = db_.get_asset_key(addr, sym_id);
+        auto entry = new cache_entry<T>(data);
+        auto s     = cache_->Insert(k, (void*)entry, v.size(),
+            [](auto& ck, auto cv) { delete (cache_entry<T>*)cv; }, nullptr /* handle */);
+        FC_ASSERT(s == rocksdb::Status::OK());
+    }
+
 private:
     void
     watch_db() {
@@ -153,6 +199,12 @@ private:
         db_.remove_token_value.connect([this](auto& key) {
             cache_->Erase(key);
         });
+        db_.rollback_asset_value.connect([this](auto& key) {
+            cache_->Erase(key);
+        });
+        db_.update_asset_value.connect([this](auto& key) {
+            cache_->Erase(key);
+        });
     }
 
 private:
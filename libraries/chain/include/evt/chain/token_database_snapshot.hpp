@@ -11,7 +11,8 @@ class token_database;
 
 namespace token_database_snapshot {
 
-void add_to_snapshot(snapshot_writer_ptr snapshot, const token_database& db);
+// sections are scanned on `threads` threads when the writer supports it, token database must not change meanwhile
+void add_to_snapshot(snapshot_writer_ptr snapshot, const token_database& db, size_t threads = 1);
 void read_from_snapshot(snapshot_reader_ptr snapshot, token_database& db);
 
 }  // namespace token_database_snapshot
@@ -1,11 +1,108 @@
 #include <evt/chain/snapshot.hpp>
 
+#include <deque>
+#include <sstream>
 #include <boost/algorithm/string/predicate.hpp>
 #include <fc/scoped_exit.hpp>
 #include <evt/chain/exceptions.hpp>
+#include <evt/chain/thread_utils.hpp>
 
 namespace evt { namespace chain {
 
+namespace detail {
+
+// renders one section in memory, either packed rows in the format of `ostream_snapshot_writer` or only their hash
+class section_buffer_writer : public snapshot_writer {
+public:
+    section_buffer_writer(snapshot_section_buffer& buffer, bool hash_only)
+        : buffer(buffer)
+        , hash_only(hash_only)
+        , wrapper(ss) {}
+
+    void
+    write_start_section(const std::string& section_name) override {
+        buffer.name      = section_name;
+        buffer.row_count = 0;
+    }
+
+    void
+    write_row(const detail::abstract_snapshot_row_writer& row_writer) override {
+        if(hash_only) {
+            row_writer.write(enc);
+        }
+        else {
+            row_writer.write(wrapper);
+        }
+        buffer.row_count++;
+    }
+
+    void
+    write_end_section() override {
+        if(hash_only) {
+            buffer.hash = enc.result();
+        }
+        else {
+            buffer.data = ss.str();
+        }
+    }
+
+private:
+    snapshot_section_buffer& buffer;
+    bool                     hash_only;
+    std::ostringstream       ss;
+    ostream_wrapper          wrapper;
+    fc::sha256::encoder      enc;
+};
+
+}  // namespace detail
+
+void
+snapshot_writer::write_sections(const std::vector<std::string>& section_names, size_t threads, const section_func& f) {
+    auto mode = section_buffer_mode();
+    if(mode == buffer_mode::none || threads <= 1 || section_names.size() <= 1) {
+        for(auto i = 0u; i < section_names.size(); i++) {
+            write_section(section_names[i], [&f, i](auto& section) {
+                f(i, section);
+            });
+        }
+        return;
+    }
+
+    auto pool    = boost::asio::thread_pool(threads);
+    auto pending = std::deque<std::future<snapshot_section_buffer>>();
+    auto next    = 0u;
+
+    auto render = [&](size_t i) {
+        return async_thread_pool(pool, [&, i] {
+            auto buffer = snapshot_section_buffer();
+            auto writer = detail::section_buffer_writer(buffer, mode == buffer_mode::hash);
+            writer.write_section(section_names[i], [&f, i](auto& section) {
+                f(i, section);
+            });
+            return buffer;
+        });
+    };
+
+    // only a window of rendered sections is held in memory, they're written in order as soon as they're ready
+    for(; next < section_names.size() && pending.size() < threads * 2; next++) {
+        pending.emplace_back(render(next));
+    }
+    while(!pending.empty()) {
+        auto buffer = pending.front().get();
+        pending.pop_front();
+        if(next < section_names.size()) {
+            pending.emplace_back(render(next++));
+        }
+        write_section_buffer(std::move(buffer));
+    }
+    pool.join();
+}
+
+void
+snapshot_writer::write_section_buffer(snapshot_section_buffer&&) {
+    EVT_THROW(snapshot_exception, "Snapshot writer doesn't support writing section buffers");
+}
+
 variant_snapshot_writer::variant_snapshot_writer(fc::mutable_variant_object& snapshot)
     : snapshot(snapshot) {
     snapshot.set("sections", fc::variants());
@@ -211,6 +308,20 @@ ostream_snapshot_writer::write_end_section() {
     row_count   = 0;
 }
 
+void
+ostream_snapshot_writer::write_section_buffer(snapshot_section_buffer&& buffer) {
+    EVT_ASSERT(section_pos == std::streampos(-1), snapshot_exception, "Attempting to write a new section without closing the previous section");
+
+    // same layout as written by `write_start_section` and `write_end_section`
+    uint64_t section_size = sizeof(uint64_t) + buffer.name.size() + 1 + buffer.data.size();
+
+    snapshot.write((char*)&section_size, sizeof(section_size));
+    snapshot.write((char*)&buffer.row_count, sizeof(buffer.row_count));
+    snapshot.write(buffer.name.data(), buffer.name.size());
+    snapshot.put('\0');
+    snapshot.write(buffer.data.data(), buffer.data.size());
+}
+
 void
 ostream_snapshot_writer::finalize() {
     uint64_t end_marker = std::numeric_limits<uint64_t>::max();
@@ -394,17 +505,23 @@ integrity_hash_snapshot_writer::integrity_hash_snapshot_writer(fc::sha256::encod
 
 void
 integrity_hash_snapshot_writer::write_start_section(const std::string&) {
-    // no-op for structural details
+    section_enc.reset();
 }
 
 void
 integrity_hash_snapshot_writer::write_row(const detail::abstract_snapshot_row_writer& row_writer) {
-    row_writer.write(enc);
+    row_writer.write(section_enc);
 }
 
 void
 integrity_hash_snapshot_writer::write_end_section() {
-    // no-op for structural details
+    auto hash = section_enc.result();
+    enc.write(hash.data(), hash.data_size());
+}
+
+void
+integrity_hash_snapshot_writer::write_section_buffer(snapshot_section_buffer&& buffer) {
+    enc.write(buffer.hash.data(), buffer.hash.data_size());
 }
 
 void
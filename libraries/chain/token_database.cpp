@@ -8,9 +8,12 @@
 #define __cpp_lib_string_view
 #endif
 
+#include <algorithm>
 #include <deque>
 #include <fstream>
+#include <map>
 #include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <rocksdb/db.h>
@@ -18,6 +21,8 @@
 #include <rocksdb/options.h>
 #include <rocksdb/filter_policy.h>
 #include <rocksdb/slice_transform.h>
+#include <rocksdb/sst_file_writer.h>
+#include <rocksdb/utilities/checkpoint.h>
 #include <rocksdb/statistics.h>
 #include <rocksdb/table.h>
 
@@ -52,6 +57,8 @@ const char*  kAssetsColumnFamilyName = "Assets";
 const size_t kSymbolIdSize           = sizeof(symbol_id_type);
 const size_t kPublicKeySize          = sizeof(fc::ecc::public_key_shim);
 const size_t kDefaultSavePointsSize  = (4 / 3 * 24 + 1) * 12;
+const size_t kBulkSstFileSize        = 256 * 1024 * 1024;
+const char*  kCheckpointCacheFilename = "checkpoint-cache.log";
 
 struct db_token_key : boost::noncopyable {
 public:
@@ -175,9 +182,18 @@ public:
     };
 };
 
+// undo action
+// prior value of the key captured when writing, empty value means key is not existed
+struct ul_action {
+    uint16_t    type;
+    std::string key;
+    std::string value;
+};
+
 struct rt_group {
     const void*                rb_snapshot;
     small_vector<rt_action, 4> actions;
+    std::vector<ul_action>     undo_actions;
 };
 
 // persistent action
@@ -281,7 +297,7 @@ public:
 
 public:
     void add_savepoint(int64_t seq);
-    void rollback_to_latest_savepoint();
+    void rollback_to_latest_savepoint(std::function<void(const llvm::StringRef&)> rollback_func);
     void squash();
     void pop_front(std::function<void(const llvm::StringRef&, std::string&&)> persist_func);
     void pop_back();
@@ -290,10 +306,16 @@ public:
     void persist_savepoints(std::ostream& os) const;
     void load_savepoints(std::istream& is);
 
+private:
+    void erase(data_map_t::value_type* it);
+
 private:
     data_map_t                data_;
     fc::ring_vector<data_ops> ops_;
 
+    // keys of cached values in order, used by range scans
+    std::map<llvm::StringRef, data_map_t::value_type*> index_;
+
 private:
     friend class token_database_impl;
 };
@@ -310,9 +332,16 @@ write_cache_layer::put(const std::string_view& key, const std::string_view& valu
         ops_.back().vec.emplace_back(data_op(pair.first, std::move(pv)));
         return;
     }
+    index_.emplace(pair.first->first(), &(*pair.first));
     ops_.back().vec.emplace_back(data_op(pair.first, std::string()));
 }
 
+void
+write_cache_layer::erase(data_map_t::value_type* it) {
+    index_.erase(it->first());
+    data_.erase(it->first());
+}
+
 int
 write_cache_layer::read(const std::string_view& key, std::string& value) const {
     auto it = data_.find(llvm::StringRef(key.data(), key.size()));
@@ -334,12 +363,13 @@ write_cache_layer::add_savepoint(int64_t seq) {
 }
 
 void
-write_cache_layer::rollback_to_latest_savepoint() {
+write_cache_layer::rollback_to_latest_savepoint(std::function<void(const llvm::StringRef&)> rollback_func) {
     auto& ops = ops_.back();
     for(auto it = ops.vec.rbegin(); it != ops.vec.rend(); it++) {
         auto& op = *it;
+        rollback_func(op.it->first());
         if(--op.it->second.used_count == 0) {
-            data_.erase(op.it->first());
+            erase(op.it);
         }
         else {
             assert(!op.it->second.value.empty());
@@ -361,13 +391,30 @@ write_cache_layer::squash() {
 
 void
 write_cache_layer::pop_front(std::function<void(const llvm::StringRef&, std::string&&)> persist_func) {
+    // keys still written by later savepoints stay in cache,
+    // but their values at the end of front savepoint need to be persisted as well
+    auto pending = std::unordered_set<data_map_t::value_type*>();
     for(auto& op : ops_.front().vec) {
         if(--op.it->second.used_count == 0) {
+            pending.erase(op.it);
             persist_func(op.it->first(), std::move(op.it->second.value));
-            data_.erase(op.it->first());
+            erase(op.it);
+        }
+        else {
+            pending.emplace(op.it);
         }
     }
 
+    // that value is the previous value recorded by the first write of the key afterwards
+    for(auto i = 1u; i < ops_.size() && !pending.empty(); i++) {
+        for(auto& op : ops_[i].vec) {
+            if(pending.erase(op.it)) {
+                persist_func(op.it->first(), std::string(op.pv));
+            }
+        }
+    }
+    assert(pending.empty());
+
     ops_.pop_front();
 }
 
@@ -392,6 +439,7 @@ struct wc_entry_pack {
 
 void
 write_cache_layer::clear() {
+    index_.clear();
     data_.clear();
     ops_.clear();
 }
@@ -400,18 +448,27 @@ void
 write_cache_layer::persist_savepoints(std::ostream& os) const {
     using namespace internal;
 
+    // value written by one op is the previous value recorded by the next write of the same key,
+    // only the last write of a key holds the current value
+    auto next = std::unordered_map<const data_map_t::value_type*, const std::string*>();
+
     auto pack = std::vector<wc_entry_pack>();
     pack.resize(ops_.size());
-    for(auto i = 0; i < ops_.size(); i++) {
+    for(auto i = (int)ops_.size() - 1; i >= 0; i--) {
         auto& ops = ops_[i];
         
         auto& epack = pack[i];
         epack.seq   = ops.seq;
-        for(auto& op : ops.vec) {
-            epack.vec.emplace_back(wc_entry {
+        epack.vec.resize(ops.vec.size());
+        for(auto j = (int)ops.vec.size() - 1; j >= 0; j--) {
+            auto& op = ops.vec[j];
+            auto  it = next.find(op.it);
+
+            epack.vec[j] = wc_entry {
                 .k  = op.it->first().str(),
-                .v  = op.it->second.value
-            });
+                .v  = (it != next.end()) ? *it->second : op.it->second.value
+            };
+            next[op.it] = &op.pv;
         }
     }
     fc::raw::pack(os, pack);
@@ -432,6 +489,119 @@ write_cache_layer::load_savepoints(std::istream& is) {
     }
 }
 
+// Writes rows into sst files and ingests them into db all at once, which skips memtables, WAL and most of
+// the compactions of plain writes. Sst files require strictly increasing keys, rows out of order are kept
+// and written normally after ingestion.
+class sst_bulk_loader : boost::noncopyable {
+private:
+    struct sink {
+    public:
+        sink(const char* name, rocksdb::ColumnFamilyHandle* handle)
+            : name(name)
+            , handle(handle) {}
+
+    public:
+        const char*                                      name;
+        rocksdb::ColumnFamilyHandle*                     handle;
+        std::unique_ptr<rocksdb::SstFileWriter>          writer;
+        std::vector<std::string>                         files;
+        std::string                                      last_key;
+        std::vector<std::pair<std::string, std::string>> deferred;
+        uint64_t                                         rows = 0;
+    };
+
+public:
+    sst_bulk_loader(rocksdb::DB* db, const fc::path& dir, rocksdb::ColumnFamilyHandle* tokens, rocksdb::ColumnFamilyHandle* assets)
+        : db_(db)
+        , dir_(dir)
+        , tokens_("tokens", tokens)
+        , assets_("assets", assets) {
+        fc::remove_all(dir_);
+        fc::create_directories(dir_);
+    }
+
+    ~sst_bulk_loader() {
+        tokens_.writer.reset();
+        assets_.writer.reset();
+        fc::remove_all(dir_);
+    }
+
+public:
+    void put_token(const rocksdb::Slice& key, const rocksdb::Slice& value) { put(tokens_, key, value); }
+    void put_asset(const rocksdb::Slice& key, const rocksdb::Slice& value) { put(assets_, key, value); }
+
+    void
+    ingest(const rocksdb::WriteOptions& write_opts) {
+        ingest(tokens_, write_opts);
+        ingest(assets_, write_opts);
+    }
+
+private:
+    void
+    check(const rocksdb::Status& status) {
+        if(!status.ok()) {
+            EVT_THROW(token_database_rocksdb_exception, "Rocksdb internal error: ${err}", ("err", status.ToString()));
+        }
+    }
+
+    void
+    put(sink& s, const rocksdb::Slice& key, const rocksdb::Slice& value) {
+        if(!s.last_key.empty() && key.compare(rocksdb::Slice(s.last_key)) <= 0) {
+            s.deferred.emplace_back(key.ToString(), value.ToString());
+            return;
+        }
+        if(!s.writer) {
+            auto file = (dir_ / fmt::format("{}-{}.sst", s.name, s.files.size())).to_native_ansi_path();
+
+            s.writer = std::make_unique<rocksdb::SstFileWriter>(rocksdb::EnvOptions(), db_->GetOptions(s.handle), s.handle);
+            check(s.writer->Open(file));
+            s.files.emplace_back(std::move(file));
+        }
+        check(s.writer->Put(key, value));
+        s.last_key.assign(key.data(), key.size());
+        s.rows++;
+
+        if(s.writer->FileSize() >= internal::kBulkSstFileSize) {
+            finish_file(s);
+        }
+    }
+
+    void
+    finish_file(sink& s) {
+        check(s.writer->Finish());
+        s.writer.reset();
+    }
+
+    void
+    ingest(sink& s, const rocksdb::WriteOptions& write_opts) {
+        if(s.writer) {
+            finish_file(s);
+        }
+        if(!s.files.empty()) {
+            auto opts       = rocksdb::IngestExternalFileOptions();
+            opts.move_files = true;
+            check(db_->IngestExternalFile(s.handle, s.files, opts));
+        }
+        if(!s.deferred.empty()) {
+            auto batch = rocksdb::WriteBatch();
+            for(auto& kv : s.deferred) {
+                batch.Put(s.handle, kv.first, kv.second);
+            }
+            check(db_->Write(write_opts, &batch));
+        }
+        ilog2_("Ingested {:n} {} rows in {} sst files and wrote {:n} rows out of order", s.rows, s.name, s.files.size(), s.deferred.size());
+
+        s.files.clear();
+        s.deferred.clear();
+    }
+
+private:
+    rocksdb::DB* db_;
+    fc::path     dir_;
+    sink         tokens_;
+    sink         assets_;
+};
+
 class token_database_impl : boost::noncopyable {
 public:
     token_database_impl(token_database& self, const token_database::config& config);
@@ -449,15 +619,26 @@ public:
                     const small_vector_base<std::string_view>& data);
     void put_asset(const address& addr, const symbol_id_type sym_id, const std::string_view& data);
 
+    void begin_bulk_load();
+    void end_bulk_load();
+
     int exists_token(const name128& prefix, const name128& key) const;
     int exists_asset(const address& addr, const symbol_id_type sym_id) const;
 
     int read_token(const name128& prefix, const name128& key, std::string& out, bool no_throw = false) const;
     int read_asset(const address& addr, const symbol_id_type sym_id, std::string& out, bool no_throw = false) const;
+    int read_asset_by_key(const std::string_view& key, std::string& out) const;
 
     int read_tokens_range(const name128& prefix, int skip, const read_value_func& func) const;
     int read_assets_range(const symbol_id_type sym_id, int skip, const read_value_func& func) const;
 
+    int scan_tokens_range(const name128& prefix, const std::string_view& start, const read_view_func& func) const;
+    int scan_assets_range(const symbol_id_type sym_id, const std::string_view& start, const read_view_func& func) const;
+
+private:
+    int read_range(rocksdb::ColumnFamilyHandle* handle, const write_cache_layer& write_cache, const std::string_view& prefix, int skip, const read_value_func& func) const;
+    int scan_range(rocksdb::ColumnFamilyHandle* handle, const write_cache_layer& write_cache, const std::string_view& prefix, const std::string_view& start, const read_view_func& func) const;
+
 public:
     void add_savepoint(int64_t seq);
     void rollback_to_latest_savepoint();
@@ -471,13 +652,21 @@ public:
 
     void rollback_rt_group(internal::rt_group*);
     void rollback_pd_group(internal::pd_group*);
+    void rollback_ul_actions(internal::rt_group*);
+    void release_snapshot(internal::rt_group*);
 
     int should_record() { return !savepoints_.empty(); }
+    // token writes stay in write cache while it's enabled or still holds values loaded from last run
+    int should_cache_tokens() { return should_record() && (config_.tokens_write_cache || !tokens_write_cache_.data_.empty()); }
 
     void record(uint8_t action_type, uint8_t op, uint8_t data_type, void* data);
+    void record_undo(token_type type, action_op op, const rocksdb::Slice& key);
     void free_savepoint(internal::savepoint&);
     void free_all_savepoints();
 
+    void create_checkpoint(const fc::path& dir) const;
+    void load_checkpoint_cache();
+
     void persist_savepoints() const;
     void load_savepoints();
     void persist_savepoints(std::ostream&) const;
@@ -497,9 +686,12 @@ public:
     rocksdb::ColumnFamilyHandle* tokens_handle_;
     rocksdb::ColumnFamilyHandle* assets_handle_;
 
+    write_cache_layer tokens_write_cache_;
     write_cache_layer assets_write_cache_;
 
     fc::ring_vector<internal::savepoint> savepoints_;
+
+    std::unique_ptr<sst_bulk_loader> bulk_loader_;
 };
 
 token_database_impl::token_database_impl(token_database& self, const token_database::config& config)
@@ -608,6 +800,7 @@ token_database_impl::open(int load_persistence) {
     tokens_handle_ = handles[0];
     assets_handle_ = handles[1];
 
+    load_checkpoint_cache();
     if(load_persistence) {
         load_savepoints();
     }
@@ -622,7 +815,11 @@ token_database_impl::close(int persist) {
         if(!savepoints_.empty()) {
             free_all_savepoints();
         }
-        
+        tokens_write_cache_.clear();
+        assets_write_cache_.clear();
+        // unfinished bulk load is discarded
+        bulk_loader_.reset();
+
         delete tokens_handle_;
         delete assets_handle_;
         delete db_;
@@ -635,12 +832,24 @@ void
 token_database_impl::put_token(token_type type, action_op op, const name128& prefix, const name128& key, const std::string_view& data) {
     using namespace internal;
 
-    auto dbkey  = db_token_key(prefix, key);
+    auto dbkey = db_token_key(prefix, key);
+    if(bulk_loader_) {
+        bulk_loader_->put_token(dbkey.as_slice(), rocksdb::Slice(data.data(), data.size()));
+        return;
+    }
+    if(should_cache_tokens()) {
+        tokens_write_cache_.put(dbkey.as_string_view(), data);
+        return;
+    }
+    if(should_record() && config_.engine == savepoint_engine::undo_log) {
+        record_undo(type, op, dbkey.as_slice());
+    }
+
     auto status = db_->Put(write_opts_, dbkey.as_slice(), data);
     if(!status.ok()) {
         FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
     }
-    if(should_record()) {
+    if(should_record() && config_.engine == savepoint_engine::snapshot) {
         void* data;
 
         // for `token` action, needs to record both prefix and key, prefix refers to the domain
@@ -671,14 +880,34 @@ token_database_impl::put_tokens(token_type type,
     using namespace internal;
     assert(keys.size() == data.size());
 
+    if(bulk_loader_) {
+        for(auto i = 0u; i < keys.size(); i++) {
+            auto dbkey = db_token_key(prefix, keys[i]);
+            bulk_loader_->put_token(dbkey.as_slice(), rocksdb::Slice(data[i].data(), data[i].size()));
+        }
+        return;
+    }
+    if(should_cache_tokens()) {
+        for(auto i = 0u; i < keys.size(); i++) {
+            auto dbkey = db_token_key(prefix, keys[i]);
+            tokens_write_cache_.put(dbkey.as_string_view(), data[i]);
+        }
+        return;
+    }
+
+    auto undo = should_record() && config_.engine == savepoint_engine::undo_log;
     for(auto i = 0u; i < keys.size(); i++) {
-        auto dbkey  = db_token_key(prefix, keys[i]);
+        auto dbkey = db_token_key(prefix, keys[i]);
+        if(undo) {
+            record_undo(type, op, dbkey.as_slice());
+        }
+
         auto status = db_->Put(write_opts_, dbkey.as_slice(), data[i]);
         if(!status.ok()) {
             FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
         }
     }
-    if(should_record()) {
+    if(should_record() && config_.engine == savepoint_engine::snapshot) {
         auto data = (rt_token_keys*)malloc(sizeof(rt_token_keys));
         data->prefix = prefix;
         new(&data->keys) token_keys_t(std::move(keys));
@@ -692,6 +921,12 @@ token_database_impl::put_asset(const address& addr, const symbol_id_type sym_id,
     using namespace internal;
 
     auto dbkey = db_asset_key(addr, sym_id);
+    self_.update_asset_value(dbkey.as_slice());
+
+    if(bulk_loader_) {
+        bulk_loader_->put_asset(dbkey.as_slice(), rocksdb::Slice(data.data(), data.size()));
+        return;
+    }
     if(should_record()) {
         assets_write_cache_.put(dbkey.as_string_view(), data);
         return;
@@ -704,12 +939,35 @@ token_database_impl::put_asset(const address& addr, const symbol_id_type sym_id,
     }
 }
 
+void
+token_database_impl::begin_bulk_load() {
+    EVT_ASSERT(db_ != nullptr, token_database_exception, "Token database is not opened");
+    EVT_ASSERT(!bulk_loader_, token_database_exception, "Token database is already in bulk loading");
+    EVT_ASSERT(savepoints_.empty(), token_database_exception, "Cannot bulk load into token database with savepoints");
+
+    // files are kept beside the db folder and moved into it when ingesting
+    auto dir = fc::path(config_.db_path.to_native_ansi_path() + "-bulk");
+    bulk_loader_ = std::make_unique<sst_bulk_loader>(db_, dir, tokens_handle_, assets_handle_);
+}
+
+void
+token_database_impl::end_bulk_load() {
+    EVT_ASSERT(bulk_loader_, token_database_exception, "Token database is not in bulk loading");
+
+    auto loader = std::move(bulk_loader_);
+    loader->ingest(write_opts_);
+}
+
 int
 token_database_impl::exists_token(const name128& prefix, const name128& key) const {
     using namespace internal;
 
     auto dbkey  = db_token_key(prefix, key);
     auto value  = std::string();
+
+    if(tokens_write_cache_.exists(dbkey.as_string_view())) {
+        return true;
+    }
     auto status = db_->Get(read_opts_, dbkey.as_slice(), &value);
     return status.ok();
 }
@@ -732,7 +990,11 @@ int
 token_database_impl::read_token(const name128& prefix, const name128& key, std::string& out, bool no_throw) const {
     using namespace internal;
 
-    auto dbkey  = db_token_key(prefix, key);
+    auto dbkey = db_token_key(prefix, key);
+    if(tokens_write_cache_.read(dbkey.as_string_view(), out)) {
+        return true;
+    }
+
     auto status = db_->Get(read_opts_, dbkey.as_slice(), &out);
     if(!status.ok()) {
         if(!status.IsNotFound()) {
@@ -751,18 +1013,26 @@ token_database_impl::read_asset(const address& addr, const symbol_id_type sym_id
     using namespace internal;
 
     auto key = db_asset_key(addr, sym_id);
-    if(assets_write_cache_.read(key.as_string_view(), out)) {
+    if(read_asset_by_key(key.as_string_view(), out)) {
+        return true;
+    }
+    if(!no_throw) {
+        EVT_THROW2(unknown_token_database_key, "There's no balance of fungible with sym id: {} in address: {}", sym_id, addr);
+    }
+    return false;
+}
+
+int
+token_database_impl::read_asset_by_key(const std::string_view& key, std::string& out) const {
+    if(assets_write_cache_.read(key, out)) {
         return true;
     }
 
-    auto status = db_->Get(read_opts_, assets_handle_, key.as_slice(), &out);
+    auto status = db_->Get(read_opts_, assets_handle_, rocksdb::Slice(key.data(), key.size()), &out);
     if(!status.ok()) {
         if(!status.IsNotFound()) {
             FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
         }
-        if(!no_throw) {
-            EVT_THROW2(unknown_token_database_key, "There's no balance of fungible with sym id: {} in address: {}", sym_id, addr);
-        }
         return false;
     }
     return true;
@@ -770,99 +1040,111 @@ token_database_impl::read_asset(const address& addr, const symbol_id_type sym_id
 
 int
 token_database_impl::read_tokens_range(const name128& prefix, int skip, const read_value_func& func) const {
-    using namespace internal;
+    auto key = std::string_view((char*)&prefix, sizeof(prefix));
+    return read_range(tokens_handle_, tokens_write_cache_, key, skip, func);
+}
 
-    auto it    = db_->NewIterator(read_opts_);
-    auto key   = rocksdb::Slice((char*)&prefix, sizeof(prefix));
+int
+token_database_impl::read_assets_range(const symbol_id_type sym_id, int skip, const read_value_func& func) const {
+    auto key = std::string_view((char*)&sym_id, sizeof(sym_id));
+    return read_range(assets_handle_, assets_write_cache_, key, skip, func);
+}
+
+int
+token_database_impl::scan_tokens_range(const name128& prefix, const std::string_view& start, const read_view_func& func) const {
+    auto key = std::string_view((char*)&prefix, sizeof(prefix));
+    return scan_range(tokens_handle_, tokens_write_cache_, key, start, func);
+}
+
+int
+token_database_impl::scan_assets_range(const symbol_id_type sym_id, const std::string_view& start, const read_view_func& func) const {
+    auto key = std::string_view((char*)&sym_id, sizeof(sym_id));
+    return scan_range(assets_handle_, assets_write_cache_, key, start, func);
+}
+
+int
+token_database_impl::read_range(rocksdb::ColumnFamilyHandle* handle,
+                                const write_cache_layer&     write_cache,
+                                const std::string_view&      prefix,
+                                int                          skip,
+                                const read_value_func&       func) const {
     auto i     = 0;
     auto count = 0;
-    
-    it->Seek(key);
-    while(it->Valid()) {
+    scan_range(handle, write_cache, prefix, std::string_view(), [&](auto& key, auto& value) {
         if(i++ < skip) {
-            it->Next();
-            continue;
+            return true;
         }
-
         count++;
-        auto value = it->value().ToString();
-        auto key   = it->key();
+        return func(key, std::string(value));
+    });
 
-        key.remove_prefix(sizeof(prefix));
-        if(!func(key.ToStringView(), std::move(value))) {
-            delete it;
-            return count;
-        }
-        it->Next();
-    }
-    delete it;
     return count;
 }
 
 int
-token_database_impl::read_assets_range(const symbol_id_type sym_id, int skip, const read_value_func& func) const {
-    using namespace internal;
+token_database_impl::scan_range(rocksdb::ColumnFamilyHandle* handle,
+                                const write_cache_layer&     write_cache,
+                                const std::string_view&      prefix,
+                                const std::string_view&      start,
+                                const read_view_func&        func) const {
+    auto begin = std::string();
+    begin.reserve(prefix.size() + start.size());
+    begin.append(prefix).append(start);
+
+    auto cache_key = [](auto& ci) {
+        return std::string_view(ci->first.data(), ci->first.size());
+    };
 
-    // create snapshot first
-    auto ss = db_->GetSnapshot();
-    
-    // write new values from cache into db
-    for(auto& it : assets_write_cache_.data_) {
-        auto k = rocksdb::Slice(it.first().data(), it.first().size());
-        auto v = rocksdb::Slice(it.second.value.data(), it.second.value.size());
-        db_->Put(write_opts_, assets_handle_, k, v);
-    }
+    // pending values in write cache are merged into the db iterator in key order
+    // and take precedence over the values stored in db, cached keys are sought in the ordered index
+    auto& index  = write_cache.index_;
+    auto  cached = [&](auto& ci) {
+        if(ci == index.cend()) {
+            return false;
+        }
+        return cache_key(ci).substr(0, prefix.size()) == prefix;
+    };
 
-    // scan values
-    auto it    = db_->NewIterator(read_opts_, assets_handle_);
-    auto key   = rocksdb::Slice((char*)&sym_id, sizeof(sym_id));
+    auto it    = std::unique_ptr<rocksdb::Iterator>(db_->NewIterator(read_opts_, handle));
+    auto ci    = index.lower_bound(llvm::StringRef(begin.data(), begin.size()));
     auto count = 0;
-    auto i     = 0;
-    
-    it->Seek(key);
-    while(it->Valid()) {
-        if(i++ < skip) {
-            it->Next();
-            continue;
-        }
 
+    auto emit = [&](auto key, auto value) {
         count++;
-        auto value = it->value().ToString();
-        auto key   = it->key();
+        key.remove_prefix(prefix.size());
+        return func(key, value);
+    };
 
-        key.remove_prefix(sizeof(sym_id));
-        if(!func(key.ToStringView(), std::move(value))) {
-            delete it;
-            return count;
+    it->Seek(rocksdb::Slice(begin));
+    while(true) {
+        auto db_valid = it->Valid() && it->key().starts_with(rocksdb::Slice(prefix.data(), prefix.size()));
+        auto c_valid  = cached(ci);
+        if(!db_valid && !c_valid) {
+            break;
         }
-        it->Next();
-    }
-    delete it;
 
-    // restore values
-    auto snapshot_read_opts_     = read_opts_;
-    snapshot_read_opts_.snapshot = ss;
-
-    auto batch = rocksdb::WriteBatch();
-    for(auto& it : assets_write_cache_.data_) {
-        auto v = std::string();
-        auto k = rocksdb::Slice(it.first().data(), it.first().size());
-        auto s = db_->Get(snapshot_read_opts_, assets_handle_, k, &v);
-        if(s.ok()) {
-            // put value back
-            batch.Put(assets_handle_, k, v);
-        }
-        else if(s.code() == rocksdb::Status::kNotFound) {
-            // remove value
-            batch.Delete(assets_handle_, k);
+        auto dkey = db_valid ? it->key().ToStringView() : std::string_view();
+        if(c_valid) {
+            auto ckey = cache_key(ci);
+            if(!db_valid || ckey <= dkey) {
+                if(db_valid && ckey == dkey) {
+                    // value in db is overridden by write cache
+                    it->Next();
+                }
+                auto& v = ci->second->second.value;
+                if(!emit(ckey, std::string_view(v.data(), v.size()))) {
+                    break;
+                }
+                ci++;
+                continue;
+            }
         }
-        else {
-            FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", s.getState()));
+
+        if(!emit(dkey, it->value().ToStringView())) {
+            break;
         }
+        it->Next();
     }
-    auto sync_write_opts = write_opts_;
-    sync_write_opts.sync = true;
-    db_->Write(sync_write_opts, &batch);
 
     return count;
 }
@@ -879,10 +1161,15 @@ token_database_impl::add_savepoint(int64_t seq) {
         }
     }
 
+    // snapshot is not needed when tokens are never written into db directly
+    // or old values are captured by undo log
+    auto ss = (config_.tokens_write_cache || config_.engine == savepoint_engine::undo_log) ? nullptr : (const void*)db_->GetSnapshot();
+
     savepoints_.push_back(savepoint(seq, kRuntime));
-    auto rt = new rt_group { .rb_snapshot = (const void*)db_->GetSnapshot(), .actions = {} }; 
+    auto rt = new rt_group { .rb_snapshot = ss, .actions = {} }; 
     SETPOINTER(void, savepoints_.back().node.group, rt);
 
+    tokens_write_cache_.add_savepoint(seq);
     assets_write_cache_.add_savepoint(seq);
 }
 
@@ -912,7 +1199,7 @@ token_database_impl::free_savepoint(internal::savepoint& sp) {
             }
             }  // switch
         }
-        db_->ReleaseSnapshot((const rocksdb::Snapshot*)rt->rb_snapshot);
+        release_snapshot(rt);
         delete rt;
         break;
     }
@@ -934,21 +1221,29 @@ token_database_impl::free_all_savepoints() {
 
 void
 token_database_impl::pop_savepoints(int64_t until) {
+    // write caches of all the popped savepoints are persisted into underlying db in one batch
+    auto batch = rocksdb::WriteBatch();
     while(!savepoints_.empty() && savepoints_.front().seq < until) {
         auto it = std::move(savepoints_.front());
         savepoints_.pop_front();
         free_savepoint(it);
 
-        // pop write cache and persist into underlying db
+        assert(tokens_write_cache_.ops_.front().seq == it.seq);
         assert(assets_write_cache_.ops_.front().seq == it.seq);
-        auto batch = rocksdb::WriteBatch();
+        tokens_write_cache_.pop_front([&](auto& k, auto&& v) {
+            batch.Put(tokens_handle_, rocksdb::Slice(k.data(), k.size()), v);
+        });
         assets_write_cache_.pop_front([&](auto& k, auto&& v) {
             batch.Put(assets_handle_, rocksdb::Slice(k.data(), k.size()), v);
         });
-        auto sync_write_opts = write_opts_;
-        sync_write_opts.sync = true;
-        db_->Write(sync_write_opts, &batch);
     }
+    if(batch.Count() == 0) {
+        return;
+    }
+
+    auto sync_write_opts = write_opts_;
+    sync_write_opts.sync = true;
+    db_->Write(sync_write_opts, &batch);
 }
 
 void
@@ -959,6 +1254,7 @@ token_database_impl::pop_back_savepoint() {
     savepoints_.pop_back();
     free_savepoint(it);
 
+    tokens_write_cache_.pop_back();
     assets_write_cache_.pop_back();
 }
 
@@ -979,11 +1275,14 @@ token_database_impl::squash() {
 
     // add all actions from rt1 into end of rt2
     rt2->actions.insert(rt2->actions.cend(), rt1->actions.cbegin(), rt1->actions.cend());
+    rt2->undo_actions.insert(rt2->undo_actions.cend(),
+        std::make_move_iterator(rt1->undo_actions.begin()), std::make_move_iterator(rt1->undo_actions.end()));
 
     // just release rt1's snapshot
-    db_->ReleaseSnapshot((const rocksdb::Snapshot*)rt1->rb_snapshot);
+    release_snapshot(rt1);
     delete rt1;
 
+    tokens_write_cache_.squash();
     assets_write_cache_.squash();
 }
 
@@ -1015,6 +1314,28 @@ token_database_impl::record(uint8_t action_type, uint8_t op, uint8_t data_type,
     GETPOINTER(rt_group, n.group)->actions.emplace_back(rt_action(action_type, op, data_type, data));
 }
 
+void
+token_database_impl::record_undo(token_type type, action_op op, const rocksdb::Slice& key) {
+    using namespace internal;
+
+    auto n = savepoints_.back().node;
+    assert(n.f.type == kRuntime);
+
+    auto act  = ul_action();
+    act.type  = (uint16_t)type;
+    act.key   = key.ToString();
+
+    // key cannot be existed before `add` operation
+    if(op != action_op::add) {
+        auto status = db_->Get(read_opts_, key, &act.value);
+        if(!status.ok() && !status.IsNotFound()) {
+            FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
+        }
+    }
+
+    GETPOINTER(rt_group, n.group)->undo_actions.emplace_back(std::move(act));
+}
+
 namespace internal {
 
 std::string
@@ -1045,8 +1366,11 @@ void
 token_database_impl::rollback_rt_group(internal::rt_group* rt) {
     using namespace internal;
 
+    if(!rt->undo_actions.empty()) {
+        rollback_ul_actions(rt);
+    }
     if(rt->actions.empty()) {
-        db_->ReleaseSnapshot((const rocksdb::Snapshot*)rt->rb_snapshot);
+        release_snapshot(rt);
         return;
     }
 
@@ -1156,7 +1480,37 @@ token_database_impl::rollback_rt_group(internal::rt_group* rt) {
     sync_write_opts.sync = true;
     db_->Write(sync_write_opts, &batch);
 
-    db_->ReleaseSnapshot((const rocksdb::Snapshot*)rt->rb_snapshot);
+    release_snapshot(rt);
+}
+
+void
+token_database_impl::rollback_ul_actions(internal::rt_group* rt) {
+    using namespace internal;
+
+    // replay in reverse order, the earliest captured value of one key is written at last
+    auto batch = rocksdb::WriteBatch();
+    for(auto it = rt->undo_actions.rbegin(); it != rt->undo_actions.rend(); it++) {
+        auto key = rocksdb::Slice(it->key);
+        if(it->value.empty()) {
+            batch.Delete(tokens_handle_, key);
+            self_.remove_token_value(key);
+        }
+        else {
+            batch.Put(tokens_handle_, key, it->value);
+            self_.rollback_token_value(key);
+        }
+    }
+
+    auto sync_write_opts = write_opts_;
+    sync_write_opts.sync = true;
+    db_->Write(sync_write_opts, &batch);
+}
+
+void
+token_database_impl::release_snapshot(internal::rt_group* rt) {
+    if(rt->rb_snapshot != nullptr) {
+        db_->ReleaseSnapshot((const rocksdb::Snapshot*)rt->rb_snapshot);
+    }
 }
 
 void
@@ -1169,29 +1523,43 @@ token_database_impl::rollback_pd_group(internal::pd_group* pd) {
 
     // keyset is not required here,
     // because it has done during creating persist savepoint
-    // cache rollback is also no need here
-    // because cache cannot have persist value objects
+    // caches still need to be notified as they may hold values written after the savepoint was persisted
     auto batch = rocksdb::WriteBatch();
     for(auto it = pd->actions.begin(); it < pd->actions.end(); it++) {
+        auto key = rocksdb::Slice(it->key);
         switch((action_op)it->op) {
         case action_op::add: {
             assert(it->value.empty());
-            batch.Delete(it->key);
+            batch.Delete(key);
+            self_.remove_token_value(key);
             break;
         }
         case action_op::update: {
             assert(!it->value.empty());
-            batch.Put(it->key, it->value);
+            batch.Put(key, it->value);
+            self_.rollback_token_value(key);
             break;
         }
         case action_op::put: {
             // Asset type only has put op
-            auto handle = (it->type == (int)token_type::asset) ? assets_handle_ : tokens_handle_;
+            if(it->type == (int)token_type::asset) {
+                if(it->value.empty()) {
+                    batch.Delete(assets_handle_, key);
+                }
+                else {
+                    batch.Put(assets_handle_, key, it->value);
+                }
+                self_.rollback_asset_value(key);
+                break;
+            }
+
             if(it->value.empty()) {
-                batch.Delete(handle, it->key);
+                batch.Delete(tokens_handle_, key);
+                self_.remove_token_value(key);
             }
             else {
-                batch.Put(handle, it->key, it->value);
+                batch.Put(tokens_handle_, key, it->value);
+                self_.rollback_token_value(key);
             }
             break;
         }
@@ -1230,8 +1598,90 @@ token_database_impl::rollback_to_latest_savepoint() {
 
     savepoints_.pop_back();
 
+    assert(seq == tokens_write_cache_.ops_.back().seq);
+    tokens_write_cache_.rollback_to_latest_savepoint([this](auto& key) {
+        self_.rollback_token_value(rocksdb::Slice(key.data(), key.size()));
+    });
+
     assert(seq == assets_write_cache_.ops_.back().seq);
-    assets_write_cache_.rollback_to_latest_savepoint();
+    assets_write_cache_.rollback_to_latest_savepoint([this](auto& key) {
+        self_.rollback_asset_value(rocksdb::Slice(key.data(), key.size()));
+    });
+}
+
+void
+token_database_impl::create_checkpoint(const fc::path& dir) const {
+    using namespace internal;
+
+    EVT_ASSERT(!fc::exists(dir), token_database_exception, "Checkpoint folder: ${d} already exists", ("d", dir.generic_string()));
+
+    auto checkpoint = (rocksdb::Checkpoint*)nullptr;
+    auto status     = rocksdb::Checkpoint::Create(db_, &checkpoint);
+    if(!status.ok()) {
+        EVT_THROW(token_database_rocksdb_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
+    }
+    auto guard = std::unique_ptr<rocksdb::Checkpoint>(checkpoint);
+
+    // memtables are flushed before sst files are linked
+    status = checkpoint->CreateCheckpoint(dir.to_native_ansi_path());
+    if(!status.ok()) {
+        EVT_THROW(token_database_rocksdb_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
+    }
+
+    auto cached = [](auto& write_cache) {
+        auto entries = std::vector<wc_entry>();
+        entries.reserve(write_cache.data_.size());
+        for(auto& it : write_cache.data_) {
+            entries.emplace_back(wc_entry { it.first().str(), it.second.value });
+        }
+        return entries;
+    };
+
+    try {
+        auto fs = std::fstream();
+        fs.exceptions(std::fstream::failbit | std::fstream::badbit);
+        fs.open((dir / kCheckpointCacheFilename).to_native_ansi_path(), (std::ios::out | std::ios::binary));
+
+        fc::raw::pack(fs, cached(tokens_write_cache_));
+        fc::raw::pack(fs, cached(assets_write_cache_));
+
+        fs.flush();
+        fs.close();
+    }
+    EVT_CAPTURE_AND_RETHROW(token_database_persist_exception);
+}
+
+void
+token_database_impl::load_checkpoint_cache() {
+    using namespace internal;
+
+    auto filename = config_.db_path / kCheckpointCacheFilename;
+    if(!fc::exists(filename)) {
+        return;
+    }
+
+    auto tokens = std::vector<wc_entry>();
+    auto assets = std::vector<wc_entry>();
+
+    auto fs = std::fstream();
+    fs.exceptions(std::fstream::failbit | std::fstream::badbit);
+    fs.open(filename.to_native_ansi_path(), (std::ios::in | std::ios::binary));
+    fc::raw::unpack(fs, tokens);
+    fc::raw::unpack(fs, assets);
+    fs.close();
+
+    auto batch = rocksdb::WriteBatch();
+    for(auto& e : tokens) {
+        batch.Put(tokens_handle_, e.k, e.v);
+    }
+    for(auto& e : assets) {
+        batch.Put(assets_handle_, e.k, e.v);
+    }
+    auto status = db_->Write(write_opts_, &batch);
+    if(!status.ok()) {
+        FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
+    }
+    fc::remove(filename);
 }
 
 void
@@ -1255,6 +1705,7 @@ token_database_impl::persist_savepoints() const {
 
         persist_savepoints(fs);
         assets_write_cache_.persist_savepoints(fs);
+        tokens_write_cache_.persist_savepoints(fs);
 
         // clear dirty
         fs.seekp(0);
@@ -1282,11 +1733,21 @@ token_database_impl::load_savepoints() {
 
     // delete old savepoints if existed (from snapshot)
     savepoints_.clear();
+    tokens_write_cache_.clear();
     assets_write_cache_.clear();
 
     // load
     load_savepoints(fs);
     assets_write_cache_.load_savepoints(fs);
+    if(fs.peek() != std::char_traits<char>::eof()) {
+        tokens_write_cache_.load_savepoints(fs);
+    }
+    else {
+        // log is written before tokens write cache is introduced
+        for(auto i = 0u; i < savepoints_.size(); i++) {
+            tokens_write_cache_.add_savepoint(savepoints_[i].seq);
+        }
+    }
 
     // close
     fs.close();
@@ -1398,6 +1859,21 @@ token_database_impl::persist_savepoints(std::ostream& os) const {
                 }
                 }  // switch
             }  // for
+
+            // only the earliest captured value of one key is needed
+            auto ul_keys = keys_hash_set();
+            for(auto& act : rt->undo_actions) {
+                if(!ul_keys.insert(act.key).second) {
+                    continue;
+                }
+
+                auto pdact  = pd_action();
+                pdact.op    = (int)action_op::put;
+                pdact.type  = act.type;
+                pdact.key   = act.key;
+                pdact.value = act.value;
+                pd.actions.emplace_back(std::move(pdact));
+            }
             break;
         }
         }  // switch
@@ -1526,6 +2002,21 @@ token_database::read_assets_range(const symbol_id_type sym_id, int skip, const r
     return my_->read_assets_range(sym_id, skip, func);
 }
 
+int
+token_database::scan_tokens_range(token_type type, const std::optional<name128>& domain, const std::string_view& start, const read_view_func& func) const {
+    using namespace internal;
+
+    assert(type != token_type::asset);
+    assert((type == token_type::token) != (!domain.has_value()));
+    auto& prefix = domain.has_value() ? *domain : action_key_prefixes[(int)type];
+    return my_->scan_tokens_range(prefix, start, func);
+}
+
+int
+token_database::scan_assets_range(const symbol_id_type sym_id, const std::string_view& start, const read_view_func& func) const {
+    return my_->scan_assets_range(sym_id, start, func);
+}
+
 token_database::session
 token_database::new_savepoint_session(int64_t seq) {
     my_->add_savepoint(seq);
@@ -1564,6 +2055,38 @@ token_database::pop_back_savepoint() {
     my_->pop_back_savepoint();
 }
 
+void
+token_database::set_tokens_write_cache(bool enable) {
+    // values already in write cache keep being served from it until they are popped
+    my_->config_.tokens_write_cache = enable;
+}
+
+bool
+token_database::tokens_write_cache() const {
+    return my_->config_.tokens_write_cache;
+}
+
+void
+token_database::create_checkpoint(const fc::path& dir) const {
+    my_->create_checkpoint(dir);
+}
+
+bool
+token_database::bulk_load_supported() const {
+    // sst files of plain tables cannot be ingested
+    return my_->config_.bulk_restore && my_->config_.profile == storage_profile::disk;
+}
+
+void
+token_database::begin_bulk_load() {
+    my_->begin_bulk_load();
+}
+
+void
+token_database::end_bulk_load() {
+    my_->end_bulk_load();
+}
+
 void
 token_database::squash() {
     my_->squash();
@@ -1607,6 +2130,19 @@ token_database::get_db_key(token_type type, const std::optional<name128>& domain
     return dkey.as_string();
 }
 
+std::string
+token_database::get_asset_key(const address& addr, const symbol_id_type sym_id) {
+    using namespace internal;
+
+    auto dkey = db_asset_key(addr, sym_id);
+    return dkey.as_string();
+}
+
+int
+token_database::read_asset_by_key(const std::string_view& key, std::string& out) const {
+    return my_->read_asset_by_key(key, out);
+}
+
 }}  // namespace evt::chain
 
 FC_REFLECT(evt::chain::internal::pd_header, (dirty_flag));
@@ -1,6 +1,8 @@
 #include <evt/chain/token_database_snapshot.hpp>
 
 #include <string.h>
+#include <algorithm>
+#include <optional>
 #include <vector>
 #include <fmt/format.h>
 #include <rocksdb/db.h>
@@ -26,118 +28,144 @@ const char* section_names[] = {
 };
 
 void
-add_reserved_tokens(snapshot_writer_ptr          writer, 
-                    const token_database&        db, 
+add_reserved_tokens(snapshot_writer_ptr          writer,
+                    const token_database&        db,
+                    size_t                       threads,
                     std::vector<domain_name>&    domains,
                     std::vector<symbol_id_type>& symbol_ids) {
     static_assert(sizeof(section_names) / sizeof(char*) == (int)token_type::max_value + 1);
 
+    auto types = std::vector<int>();
+    auto names = std::vector<std::string>();
     for(auto i = (int)token_type::domain; i <= (int)token_type::max_value; i++) {
         if(i == (int)token_type::asset || i == (int)token_type::token) {
             continue;
         }
-        writer->write_section(section_names[i], [&](auto& w) {
-            db.read_tokens_range((token_type)i, std::nullopt, 0, [&](auto& key, auto&& v) {
-                assert(key.size() == sizeof(name128));
+        types.emplace_back(i);
+        names.emplace_back(section_names[i]);
+    }
 
-                w.add_row(key.data(), key.size());
-                w.add_row(v);
+    // each of `domains` and `symbol_ids` is only filled by its own section
+    writer->write_sections(names, threads, [&](auto index, auto& w) {
+        auto i = types[index];
+        db.scan_tokens_range((token_type)i, std::nullopt, std::string_view(), [&](auto& key, auto& v) {
+            assert(key.size() == sizeof(name128));
 
-                // we should use memcpy here
-                // it's UB when interpret char* as name128*
-                // because it may not be aligened
-                auto n = name128();
-                memcpy(&n, key.data(), sizeof(name128));
+            w.add_row(key.data(), key.size());
+            w.add_string_row(v);
 
-                if(i == (int)token_type::domain) {
-                    domains.push_back(n);
-                }
-                else if(i == (int)token_type::fungible) {
-                    symbol_ids.push_back((symbol_id_type)n.value);
-                }
+            // we should use memcpy here
+            // it's UB when interpret char* as name128*
+            // because it may not be aligened
+            auto n = name128();
+            memcpy(&n, key.data(), sizeof(name128));
 
-                return true;
-            });
+            if(i == (int)token_type::domain) {
+                domains.push_back(n);
+            }
+            else if(i == (int)token_type::fungible) {
+                symbol_ids.push_back((symbol_id_type)n.value);
+            }
+
+            return true;
         });
-    }
+    });
 }
 
 void
-add_tokens(snapshot_writer_ptr writer, const token_database& db, const std::vector<domain_name> domains) {
+add_tokens_and_assets(snapshot_writer_ptr                writer,
+                      const token_database&              db,
+                      size_t                             threads,
+                      const std::vector<domain_name>&    domains,
+                      const std::vector<symbol_id_type>& symbol_ids) {
+    auto names = std::vector<std::string>();
+    names.reserve(domains.size() + symbol_ids.size());
     for(auto& d : domains) {
-        writer->write_section(d.to_string(), [&](auto& w) {
-            db.read_tokens_range(token_type::token, d, 0, [&w](auto& key, auto&& v) {
+        names.emplace_back(d.to_string());
+    }
+    for(auto& id : symbol_ids) {
+        names.emplace_back(fmt::format(".asset-{}", id));
+    }
+
+    // sections are in the same order as the serial writes: tokens of every domain and then assets of every symbol
+    writer->write_sections(names, threads, [&](auto index, auto& w) {
+        if(index < domains.size()) {
+            db.scan_tokens_range(token_type::token, domains[index], std::string_view(), [&w](auto& key, auto& v) {
                 w.add_row(key.data(), key.size());
-                w.add_row(v);
+                w.add_string_row(v);
 
                 return true;
             });
+            return;
+        }
+
+        db.scan_assets_range(symbol_ids[index - domains.size()], std::string_view(), [&w](auto& key, auto& v) {
+            assert(key.size() == sizeof(fc::ecc::public_key_shim));
+            w.add_row(key.data(), key.size());
+            w.add_string_row(v);
+
+            return true;
         });
-    }
+    });
 }
 
+struct token_section {
+    name128                    prefix;  // prefix of the keys in token database
+    token_type                 type;
+    std::optional<domain_name> domain;
+    std::string                name;
+};
+
+template<typename Func>
 void
-add_assets(snapshot_writer_ptr writer, const token_database& db, const std::vector<symbol_id_type>& symbol_ids) {
-    for(auto& id : symbol_ids) {
-        auto sn = fmt::format(".asset-{}", id);
-        writer->write_section(sn, [&](auto& w) {
-            db.read_assets_range(id, 0, [&w](auto& key, auto&& v) {
-                assert(key.size() == sizeof(fc::ecc::public_key_shim));
-                w.add_row(key.data(), key.size());
-                w.add_row(v);
+read_section_keys(snapshot_reader_ptr reader, const std::string& name, Func&& func) {
+    reader->read_section(name, [&](auto& r) {
+        while(!r.eof()) {
+            auto k = name128();
+            auto v = std::string();
 
-                return true;
-            });
-        });
-    }
+            r.read_row((char*)&k, sizeof(k));
+            r.read_row(v);
+
+            func(k);
+        }
+    });
 }
 
 void
-read_reserved_tokens(snapshot_reader_ptr          reader,
-                     token_database&              db,
-                     std::vector<domain_name>&    domains,
-                     std::vector<symbol_id_type>& symbol_ids) {
+read_token_section(snapshot_reader_ptr reader, token_database& db, const token_section& section) {
+    reader->read_section(section.name, [&](auto& r) {
+        while(!r.eof()) {
+            auto k = name128();
+            auto v = std::string();
+
+            r.read_row((char*)&k, sizeof(k));
+            r.read_row(v);
+
+            db.put_token(section.type, action_op::put, section.domain, k, std::string_view(v.data(), v.size()));
+        }
+    });
+}
+
+// sections are ordered as their keys in token database, rows in each section are already in order
+// so all the rows are put in the total order of keys, which is required by bulk loading
+std::vector<token_section>
+sorted_token_sections(const std::vector<domain_name>& domains) {
+    auto sections = std::vector<token_section>();
     for(auto i = (int)token_type::domain; i <= (int)token_type::max_value; i++) {
         if(i == (int)token_type::asset || i == (int)token_type::token) {
             continue;
         }
-
-        reader->read_section(section_names[i], [&](auto& r) {
-            while(!r.eof()) {
-                auto k = uint128_t(0);
-                auto v = std::string();
-
-                r.read_row((char*)&k, sizeof(k));
-                r.read_row(v);
-
-                db.put_token((token_type)i, action_op::put, std::nullopt, k, std::string_view(v.data(), v.size()));
-
-                if(i == (int)token_type::domain) {
-                    domains.emplace_back(k);
-                }
-                else if(i == (int)token_type::fungible) {
-                    symbol_ids.emplace_back((symbol_id_type)k);
-                }
-            }
-        });
+        sections.emplace_back(token_section { name128(section_names[i]), (token_type)i, std::nullopt, section_names[i] });
     }
-}
-
-void
-read_tokens(snapshot_reader_ptr reader, token_database& db, const std::vector<domain_name>& domains) {
     for(auto& d : domains) {
-        reader->read_section(d.to_string(), [&](auto& r) {
-            while(!r.eof()) {
-                auto k = name128();
-                auto v = std::string();
-
-                r.read_row((char*)&k, sizeof(k));
-                r.read_row(v);
-
-                db.put_token(token_type::token, action_op::put, d, k, std::string_view(v.data(), v.size()));
-            }
-        });
+        sections.emplace_back(token_section { d, token_type::token, d, d.to_string() });
     }
+
+    std::sort(sections.begin(), sections.end(), [](auto& a, auto& b) {
+        return memcmp(&a.prefix, &b.prefix, sizeof(name128)) < 0;
+    });
+    return sections;
 }
 
 void
@@ -162,16 +190,15 @@ read_assets(snapshot_reader_ptr reader, token_database& db, const std::vector<sy
 }  // namespace internal
 
 void
-token_database_snapshot::add_to_snapshot(snapshot_writer_ptr writer, const token_database& db) {
+token_database_snapshot::add_to_snapshot(snapshot_writer_ptr writer, const token_database& db, size_t threads) {
     using namespace internal;
 
     try {
         auto domains    = std::vector<domain_name>();
         auto symbol_ids = std::vector<symbol_id_type>();
 
-        add_reserved_tokens(writer, db, domains, symbol_ids);
-        add_tokens(writer, db, domains);
-        add_assets(writer, db, symbol_ids);
+        add_reserved_tokens(writer, db, threads, domains, symbol_ids);
+        add_tokens_and_assets(writer, db, threads, domains, symbol_ids);
     }
     EVT_CAPTURE_AND_RETHROW(token_database_snapshot_exception);
 }
@@ -187,12 +214,37 @@ token_database_snapshot::read_from_snapshot(snapshot_reader_ptr reader, token_da
 
         FC_ASSERT(db.savepoints_size() == 0);
 
+        auto start      = fc::time_point::now();
         auto domains    = std::vector<domain_name>();
         auto symbol_ids = std::vector<symbol_id_type>();
 
-        read_reserved_tokens(reader, db, domains, symbol_ids);
-        read_tokens(reader, db, domains);
-        read_assets(reader, db, symbol_ids);        
+        read_section_keys(reader, section_names[(int)token_type::domain], [&](auto& k) {
+            domains.emplace_back(k);
+        });
+        read_section_keys(reader, section_names[(int)token_type::fungible], [&](auto& k) {
+            symbol_ids.emplace_back((symbol_id_type)k.value);
+        });
+
+        auto sections = sorted_token_sections(domains);
+        // symbol id is the raw prefix of asset keys
+        std::sort(symbol_ids.begin(), symbol_ids.end(), [](auto& a, auto& b) {
+            return memcmp(&a, &b, sizeof(symbol_id_type)) < 0;
+        });
+
+        auto bulk = db.bulk_load_supported();
+        if(bulk) {
+            db.begin_bulk_load();
+        }
+        for(auto& section : sections) {
+            read_token_section(reader, db, section);
+        }
+        read_assets(reader, db, symbol_ids);
+        if(bulk) {
+            db.end_bulk_load();
+        }
+
+        ilog2_("Restored token database from snapshot with {} domains and {} fungibles in {} ms{}", domains.size(), symbol_ids.size(),
+            (fc::time_point::now() - start).count() / 1000, bulk ? " by bulk loading" : "");
     }
     EVT_CAPTURE_AND_RETHROW(token_database_snapshot_exception);
 }
@@ -9,6 +9,7 @@
 #include <evt/chain/controller.hpp>
 #include <evt/chain/exceptions.hpp>
 #include <evt/chain/global_property_object.hpp>
+#include <evt/chain/token_database_cache.hpp>
 #include <evt/chain/transaction_object.hpp>
 
 namespace evt { namespace chain {
@@ -75,7 +76,8 @@ transaction_context::init_for_implicit_trx() {
 void
 transaction_context::init_for_input_trx(bool skip_recording) {
     is_input = true;
-    if(!control.loadtest_mode() || !control.skip_trx_checks()) {
+    // irreversible blocks in fast replay were validated when they were accepted
+    if(!control.replay_fast_mode() && (!control.loadtest_mode() || !control.skip_trx_checks())) {
         control.validate_expiration(trx);
         control.validate_tapos(trx);
     }
@@ -160,23 +162,23 @@ transaction_context::check_charge() {
     }
 }
 
-#define READ_DB_ASSET_NO_THROW(ADDR, SYM_ID, VALUEREF)                     \
-    {                                                                      \
-        auto str = std::string();                                          \
-        if(!tokendb.read_asset(ADDR, SYM_ID, str, true /* no throw */)) {  \
-            VALUEREF = property();                                         \
-        }                                                                  \
-        else {                                                             \
-            extract_db_value(str, VALUEREF);                               \
-        }                                                                  \
+#define READ_DB_ASSET_NO_THROW(ADDR, SYM_ID, VALUEREF)                                     \
+    {                                                                                      \
+        auto vptr = tokendb_cache.read_asset<property>(ADDR, SYM_ID, true /* no throw */); \
+        if(vptr == nullptr) {                                                              \
+            VALUEREF = property();                                                         \
+        }                                                                                  \
+        else {                                                                             \
+            VALUEREF = *vptr;                                                              \
+        }                                                                                  \
     }
 
 void
 transaction_context::check_paid() const {
     using namespace contracts;
 
-    auto& tokendb = control.token_db();
-    auto& payer = trx.payer;
+    auto& tokendb_cache = control.token_db_cache();
+    auto& payer         = trx.payer;
 
     switch(payer.type()) {
     case address::reserved_t: {
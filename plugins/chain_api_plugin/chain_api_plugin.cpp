@@ -97,6 +97,40 @@ get_json<std::string>(const std::string& value) {
 #define CHAIN_RO_CALL_ASYNC(call_name, call_result, http_response_code) CALL_ASYNC(chain, ro_api, chain_apis::read_only, call_name, call_result, http_response_code)
 #define CHAIN_RW_CALL_ASYNC(call_name, call_result, http_response_code) CALL_ASYNC(chain, rw_api, chain_apis::read_write, call_name, call_result, http_response_code)
 
+// Irreversible blocks are read from block log right on the http thread,
+// others are in fork database and have to be fetched on the main thread
+static url_handler
+get_block_handler(chain_apis::read_only ro_api) {
+    return [ro_api](string, string body, url_response_callback cb) mutable {
+        try {
+            if(body.empty()) {
+                body = "{}";
+            }
+            auto params = fc::json::from_string(body).as<chain_apis::read_only::get_block_params>();
+            auto result = ro_api.get_irreversible_block(params);
+            if(!result.empty()) {
+                cb(200, std::move(result));
+                return;
+            }
+
+            app().post(appbase::priority::low, [ro_api, params, body, cb] {
+                try {
+                    auto result = ro_api.get_block(params);
+                    app().get_plugin<http_plugin>().post_http_thread_pool([result, cb] {
+                        cb(200, fc::json::to_string(result));
+                    });
+                }
+                catch(...) {
+                    http_plugin::handle_exception("chain", "get_block", body, cb);
+                }
+            });
+        }
+        catch(...) {
+            http_plugin::handle_exception("chain", "get_block", body, cb);
+        }
+    };
+}
+
 void
 chain_api_plugin::plugin_startup() {
     ilog("starting chain_api_plugin");
@@ -107,15 +141,17 @@ chain_api_plugin::plugin_startup() {
     auto& _http_plugin = app().get_plugin<http_plugin>();
     ro_api.set_shorten_abi_errors(!_http_plugin.verbose_errors());
 
+    // these only read block log, abi serializer and action versions of execution context,
+    // which are safe to use from http threads as versions are atomic and only changed on main thread
+    _http_plugin.add_thread_safe_api({{std::string("/v1/chain/get_block"), get_block_handler(ro_api)},
+                                      CHAIN_RO_CALL(abi_json_to_bin, 200),
+                                      CHAIN_RO_CALL(abi_bin_to_json, 200),
+                                      CHAIN_RO_CALL(trx_json_to_digest, 200)});
     _http_plugin.add_api({CHAIN_RO_CALL(get_info, 200),
-                          CHAIN_RO_CALL(get_block, 200),
                           CHAIN_RO_CALL(get_block_header_state, 200),
                           CHAIN_RO_CALL(get_head_block_header_state, 200),
                           CHAIN_RO_CALL(get_transaction, 200),
                           CHAIN_RO_CALL(get_trx_id_for_link_id, 200),
-                          CHAIN_RO_CALL(abi_json_to_bin, 200),
-                          CHAIN_RO_CALL(abi_bin_to_json, 200),
-                          CHAIN_RO_CALL(trx_json_to_digest, 200),
                           CHAIN_RO_CALL(get_required_keys, 200),
                           CHAIN_RO_CALL(get_suspend_required_keys, 200),
                           CHAIN_RO_CALL(get_charge, 200),
@@ -125,7 +161,9 @@ chain_api_plugin::plugin_startup() {
                           CHAIN_RW_CALL_ASYNC(push_block, chain_apis::read_write::push_block_results, 202),
                           CHAIN_RW_CALL_ASYNC(push_transaction, chain_apis::read_write::push_transaction_results, 202),
                           CHAIN_RW_CALL_ASYNC(push_transactions, chain_apis::read_write::push_transactions_results, 202)});
-    _http_plugin.add_api({CHAIN_RO_CALL(get_db_info, 200)}, true /* local only API */);
+    _http_plugin.add_api({CHAIN_RO_CALL(get_db_info, 200),
+                          CHAIN_RO_CALL(get_auth_cache_stats, 200),
+                          CHAIN_RO_CALL(get_response_cache_stats, 200)}, true /* local only API */);
 }
 
 void
@@ -12,6 +12,7 @@
 #include <fc/io/json.hpp>
 #include <fc/variant.hpp>
 
+#include <evt/chain/authority_cache.hpp>
 #include <evt/chain/block_log.hpp>
 #include <evt/chain/config.hpp>
 #include <evt/chain/exceptions.hpp>
@@ -153,6 +154,86 @@ validate(boost::any&                     v,
     }
 }
 
+std::ostream&
+operator<<(std::ostream& osm, evt::chain::savepoint_engine m) {
+    if(m == evt::chain::savepoint_engine::snapshot) {
+        osm << "snapshot";
+    }
+    else if(m == evt::chain::savepoint_engine::undo_log) {
+        osm << "undo-log";
+    }
+
+    return osm;
+}
+
+void
+validate(boost::any&                     v,
+         const std::vector<std::string>& values,
+         evt::chain::savepoint_engine* /* target_type */,
+         int) {
+    using namespace boost::program_options;
+
+    // Make sure no previous assignment to 'v' was made.
+    validators::check_first_occurrence(v);
+
+    // Extract the first string from 'values'. If there is more than
+    // one string, it's an error, and exception will be thrown.
+    std::string const& s = validators::get_single_string(values);
+
+    if(s == "snapshot") {
+        v = boost::any(evt::chain::savepoint_engine::snapshot);
+    }
+    else if(s == "undo-log") {
+        v = boost::any(evt::chain::savepoint_engine::undo_log);
+    }
+    else {
+        throw validation_error(validation_error::invalid_option_value);
+    }
+}
+
+std::ostream&
+operator<<(std::ostream& osm, evt::chain::block_log::flush_mode m) {
+    if(m == evt::chain::block_log::flush_mode::every_block) {
+        osm << "every-block";
+    }
+    else if(m == evt::chain::block_log::flush_mode::group) {
+        osm << "group";
+    }
+    else if(m == evt::chain::block_log::flush_mode::background) {
+        osm << "background";
+    }
+
+    return osm;
+}
+
+void
+validate(boost::any&                     v,
+         const std::vector<std::string>& values,
+         evt::chain::block_log::flush_mode* /* target_type */,
+         int) {
+    using namespace boost::program_options;
+
+    // Make sure no previous assignment to 'v' was made.
+    validators::check_first_occurrence(v);
+
+    // Extract the first string from 'values'. If there is more than
+    // one string, it's an error, and exception will be thrown.
+    std::string const& s = validators::get_single_string(values);
+
+    if(s == "every-block") {
+        v = boost::any(evt::chain::block_log::flush_mode::every_block);
+    }
+    else if(s == "group") {
+        v = boost::any(evt::chain::block_log::flush_mode::group);
+    }
+    else if(s == "background") {
+        v = boost::any(evt::chain::block_log::flush_mode::background);
+    }
+    else {
+        throw validation_error(validation_error::invalid_option_value);
+    }
+}
+
 }  // namespace chain
 
 using namespace evt;
@@ -207,6 +288,8 @@ public:
     std::optional<chain_id_type>      chain_id;
     std::optional<bfs::path>          snapshot_path;
 
+    std::unique_ptr<chain_apis::response_cache> responses;
+
     // retained references to channels for easy publication
     channels::pre_accepted_block::channel_type&    pre_accepted_block_channel;
     channels::accepted_block_header::channel_type& accepted_block_header_channel;
@@ -240,6 +323,8 @@ chain_plugin::chain_plugin()
     app().register_config_type<evt::chain::db_read_mode>();
     app().register_config_type<evt::chain::validation_mode>();
     app().register_config_type<evt::chain::storage_profile>();
+    app().register_config_type<evt::chain::savepoint_engine>();
+    app().register_config_type<evt::chain::block_log::flush_mode>();
 }
 
 chain_plugin::~chain_plugin() {}
@@ -248,6 +333,15 @@ void
 chain_plugin::set_program_options(options_description& cli, options_description& cfg) {
     cfg.add_options()
         ("blocks-dir", bpo::value<bfs::path>()->default_value("blocks"), "the location of the blocks directory (absolute path or relative to application data dir)")
+        ("block-log-flush-mode", boost::program_options::value<evt::chain::block_log::flush_mode>()->default_value(evt::chain::block_log::flush_mode::every_block),
+            "Flush mode of block log (\"every-block\", \"group\", or \"background\").\n"
+            "In \"every-block\" mode block log is flushed after each appended block.\n"
+            "In \"group\" mode block log is flushed when a block is appended and either block-log-flush-blocks blocks are not flushed or block-log-flush-ms milliseconds passed since last flush, so the last blocks stay unflushed until next block is appended.\n"
+            "In \"background\" mode blocks are written and flushed by a writer thread, appending waits when block-log-flush-blocks blocks are not flushed yet.\n"
+            "Blocks not flushed are lost on crash and the torn tail of block log is truncated on next start\n"
+        )
+        ("block-log-flush-blocks", bpo::value<uint32_t>()->default_value(16), "Maximum number of blocks appended to block log without being flushed in \"group\" and \"background\" modes")
+        ("block-log-flush-ms", bpo::value<uint32_t>()->default_value(500), "Milliseconds since last flush of block log after which next appended block triggers a flush in \"group\" mode, it's only checked when blocks are appended")
         ("token-db-dir", bpo::value<bfs::path>()->default_value("tokendb"), "the location of the token database directory (absolute path or relative to application data dir)")
         ("token-db-cache-size-mb", bpo::value<uint32_t>()->default_value(512), "the cache size of token database in MBytes")
         ("token-db-profile", boost::program_options::value<evt::chain::storage_profile>()->default_value(evt::chain::storage_profile::disk),
@@ -255,6 +349,13 @@ chain_plugin::set_program_options(options_description& cli, options_description&
             "In \"disk\" profile database is optimized for the standard storage devices.\n"
             "In \"memory\" mode database is optimized for the usage in ultra-low latency devices like memory\n"
         )
+        ("token-db-savepoint-engine", boost::program_options::value<evt::chain::savepoint_engine>()->default_value(evt::chain::savepoint_engine::snapshot),
+            "Engine used by token database savepoints to restore old values (\"snapshot\", or \"undo-log\").\n"
+            "In \"snapshot\" engine old values are read from database snapshots when rolling back.\n"
+            "In \"undo-log\" engine old values are captured in memory when writing and no database snapshot is held\n"
+        )
+        ("token-db-write-cache", bpo::bool_switch()->default_value(false), "Keep token writes in memory and write them into token database in one batch once they become irreversible")
+        ("token-db-bulk-restore", bpo::value<bool>()->default_value(true), "Restore token database from snapshot by ingesting sorted sst files instead of writing rows one by one, only for 'disk' profile")
         ("checkpoint", bpo::value<vector<string>>()->composing(), "Pairs of [BLOCK_NUM,BLOCK_ID] that should be enforced as checkpoints.")
         ("abi-serializer-max-time-ms", bpo::value<uint32_t>()->default_value(config::default_abi_serializer_max_time_ms), "Override default maximum ABI serialization time allowed in ms")
         ("chain-state-db-size-mb", bpo::value<uint64_t>()->default_value(config::default_state_size / (1024 * 1024)), "Maximum size (in MiB) of the chain state database")
@@ -274,6 +375,16 @@ chain_plugin::set_program_options(options_description& cli, options_description&
             "In \"full\" mode all incoming blocks will be fully validated.\n"
             "In \"light\" mode all incoming blocks headers will be fully validated; transactions in those validated blocks will be trusted \n")
         ("trusted-producer", bpo::value<vector<string>>()->composing(), "Indicate a producer whose blocks headers signed by it will be fully validated, but transactions in those validated blocks will be trusted.")
+        ("signature-recovery-threads", bpo::value<uint16_t>()->default_value(config::default_signature_recovery_threads),
+            "Number of worker threads recovering transaction signatures ahead of applying blocks and replaying block log, 0 to recover them on the main thread")
+        ("snapshot-threads", bpo::value<uint16_t>()->default_value(config::default_snapshot_threads),
+            "Number of worker threads scanning token database sections when writing snapshots or calculating integrity hash, 0 or 1 to scan them on the main thread")
+        ("auth-cache-size", bpo::value<uint32_t>()->default_value(config::default_auth_cache_size),
+            "Maximum number of authority check results memoized across transactions, 0 to disable the cache")
+        ("holder-cache-size", bpo::value<uint32_t>()->default_value(config::default_holder_cache_size),
+            "Maximum number of fungible holders indexed for passive bonus distributions (48 bytes each), 0 to disable the cache")
+        ("response-cache-size-mb", bpo::value<uint32_t>()->default_value(64),
+            "Maximum size in megabytes of cached get_block and get_transaction responses of irreversible blocks, 0 to disable the cache")
         ;
 
     cli.add_options()
@@ -284,6 +395,7 @@ chain_plugin::set_program_options(options_description& cli, options_description&
         ("fix-reversible-blocks", bpo::bool_switch()->default_value(false), "recovers reversible block database if that database is in a bad state")
         ("force-all-checks", bpo::bool_switch()->default_value(false), "do not skip any checks that can be skipped while replaying irreversible blocks")
         ("disable-replay-opts", bpo::bool_switch()->default_value(false), "disable optimizations that specifically target replay")
+        ("replay-fast", bpo::bool_switch()->default_value(false), "apply each irreversible block in replay under one token database savepoint, batch its writes and skip expiration and TaPoS checks")
         ("loadtest-mode", bpo::bool_switch()->default_value(false), "special for load-testing, skip expiration and reference block checks")
         ("charge-free-mode", bpo::bool_switch()->default_value(false), "do not charge any fees for transactions")
         ("replay-blockchain", bpo::bool_switch()->default_value(false), "clear chain state database and token database and replay all blocks")
@@ -292,6 +404,7 @@ chain_plugin::set_program_options(options_description& cli, options_description&
         ("truncate-at-block", bpo::value<uint32_t>()->default_value(0), "stop hard replay / block log recovery at this block number (if set to non-zero number)")
         ("import-reversible-blocks", bpo::value<bfs::path>(), "replace reversible block database with blocks imported from specified file and then exit")
         ("export-reversible-blocks", bpo::value<bfs::path>(), "export reversible block database in portable format into specified file and then exit")
+        ("compress-block-log", bpo::value<uint32_t>(), "compress blocks of block log into a seekable archive in chunks of specified number of blocks (e.g. 256), keep the original block log in a backup directory and then exit")
         ("trusted-producer", bpo::value<vector<string>>()->composing(), "Indicate a producer whose blocks headers signed by it will be fully validated, but transactions in those validated blocks will be trusted.")
         ("snapshot", bpo::value<bfs::path>(), "File to read Snapshot State from")
         ;
@@ -403,6 +516,12 @@ chain_plugin::plugin_initialize(const variables_map& options) {
 
         my->chain_config->db_config.db_path = my->tokendb_dir;
         
+        if(options.count("block-log-flush-mode")) {
+            my->chain_config->blog_flush_policy.mode = options.at("block-log-flush-mode").as<block_log::flush_mode>();
+        }
+        my->chain_config->blog_flush_policy.max_blocks = options.at("block-log-flush-blocks").as<uint32_t>();
+        my->chain_config->blog_flush_policy.max_ms     = options.at("block-log-flush-ms").as<uint32_t>();
+
         if(options.count("token-db-cache-size-mb")) {
             // simply alloc block cache and object cache 50% and 50%.
             auto sz = options.at("token-db-cache-size-mb").as<uint32_t>() / 2 * 1024 * 1024;
@@ -414,6 +533,13 @@ chain_plugin::plugin_initialize(const variables_map& options) {
             my->chain_config->db_config.profile = options.at("token-db-profile").as<storage_profile>();
         }
 
+        if(options.count("token-db-savepoint-engine")) {
+            my->chain_config->db_config.engine = options.at("token-db-savepoint-engine").as<savepoint_engine>();
+        }
+
+        my->chain_config->db_config.tokens_write_cache = options.at("token-db-write-cache").as<bool>();
+        my->chain_config->db_config.bulk_restore       = options.at("token-db-bulk-restore").as<bool>();
+
         if(options.count("chain-state-db-size-mb")) {
             my->chain_config->state_size = options.at("chain-state-db-size-mb").as<uint64_t>() * 1024 * 1024;
         }
@@ -432,10 +558,21 @@ chain_plugin::plugin_initialize(const variables_map& options) {
 
         my->chain_config->force_all_checks    = options.at("force-all-checks").as<bool>();
         my->chain_config->disable_replay_opts = options.at("disable-replay-opts").as<bool>();
+        my->chain_config->replay_fast         = options.at("replay-fast").as<bool>();
         my->chain_config->loadtest_mode       = options.at("loadtest-mode").as<bool>();
         my->chain_config->charge_free_mode    = options.at("charge-free-mode").as<bool>();
         my->chain_config->contracts_console   = options.at("contracts-console").as<bool>();
 
+        my->chain_config->signature_recovery_threads = options.at("signature-recovery-threads").as<uint16_t>();
+        my->chain_config->snapshot_threads           = options.at("snapshot-threads").as<uint16_t>();
+        my->chain_config->auth_cache_size            = options.at("auth-cache-size").as<uint32_t>();
+        my->chain_config->holder_cache_size          = options.at("holder-cache-size").as<uint32_t>();
+
+        auto response_cache_size = (size_t)options.at("response-cache-size-mb").as<uint32_t>() * 1024 * 1024;
+        if(response_cache_size > 0) {
+            my->responses = std::make_unique<chain_apis::response_cache>(response_cache_size);
+        }
+
         if(options.count("extract-genesis-json") || options.at("print-genesis-json").as<bool>()) {
             genesis_state gs;
 
@@ -480,6 +617,16 @@ chain_plugin::plugin_initialize(const variables_map& options) {
             EVT_THROW(node_management_success, "exported reversible blocks");
         }
 
+        if(options.count("compress-block-log")) {
+            auto backup_dir = block_log::compress_log(my->blocks_dir, options.at("compress-block-log").as<uint32_t>());
+            if(fc::exists(backup_dir / config::reversible_blocks_dir_name)) {
+                fc::rename(backup_dir / config::reversible_blocks_dir_name, my->blocks_dir / config::reversible_blocks_dir_name);
+            }
+            ilog("Compressed block log, the original one is kept in '${path}'", ("path", backup_dir.generic_string()));
+
+            EVT_THROW(node_management_success, "compressed block log");
+        }
+
         if(options.at("delete-all-blocks").as<bool>()) {
             ilog("Deleting state database and blocks");
             if(options.at("truncate-at-block").as<uint32_t>() > 0)
@@ -764,7 +911,7 @@ chain_plugin::plugin_shutdown() {
 
 chain_apis::read_only
 chain_plugin::get_read_only_api() const {
-    return chain_apis::read_only(chain());
+    return chain_apis::read_only(chain(), my->responses.get());
 }
 
 chain_apis::read_write
@@ -1109,12 +1256,56 @@ read_only::get_block(const read_only::get_block_params& params) const {
 
     EVT_ASSERT(block, unknown_block_exception, "Could not find block: ${block}", ("block", params.block_num_or_id));
 
+    return block_to_variant(*block);
+}
+
+std::string
+read_only::get_irreversible_block(const read_only::get_block_params& params) const {
+    auto block = signed_block_ptr();
+    EVT_ASSERT(!params.block_num_or_id.empty() && params.block_num_or_id.size() <= 64,
+        chain::block_id_type_exception, "Invalid Block number or ID, must be greater than 0 and less than 64 characters");
+
+    // number and id of the same block are cached separately, blocks in block log never change
+    auto key = "b" + params.block_num_or_id;
+    if(responses) {
+        if(auto r = responses->lookup(key)) {
+            return *r;
+        }
+    }
+
+    try {
+        if(params.block_num_or_id.size() == 64) {
+            auto id = fc::variant(params.block_num_or_id).as<block_id_type>();
+            block   = db.fetch_irreversible_block_by_number(block_header::num_from_id(id));
+            if(block && block->id() != id) {
+                block.reset();
+            }
+        }
+        else {
+            block = db.fetch_irreversible_block_by_number(fc::to_uint64(params.block_num_or_id));
+        }
+    }
+    EVT_RETHROW_EXCEPTIONS(chain::block_id_type_exception, "Invalid block ID: ${block_num_or_id}", ("block_num_or_id", params.block_num_or_id))
+
+    if(!block) {
+        return std::string();
+    }
+
+    auto r = std::make_shared<const std::string>(fc::json::to_string(block_to_variant(*block)));
+    if(responses) {
+        responses->insert(key, r);
+    }
+    return *r;
+}
+
+fc::variant
+read_only::block_to_variant(const signed_block& block) const {
     auto pretty_output = fc::variant();
-    db.get_abi_serializer().to_variant(*block, pretty_output, db.get_execution_context());
+    db.get_abi_serializer().to_variant(block, pretty_output, db.get_execution_context());
 
-    uint32_t ref_block_prefix = block->id()._hash[1];
+    uint32_t ref_block_prefix = block.id()._hash[1];
 
-    return fc::mutable_variant_object(pretty_output.get_object())("id", block->id())("block_num", block->block_num())("ref_block_prefix", ref_block_prefix);
+    return fc::mutable_variant_object(pretty_output.get_object())("id", block.id())("block_num", block.block_num())("ref_block_prefix", ref_block_prefix);
 }
 
 fc::variant
@@ -1156,15 +1347,25 @@ read_only::get_head_block_header_state(const get_head_block_header_state_params&
     return vo;
 }
 
-fc::variant
+std::string
 read_only::get_transaction(const get_transaction_params& params) {
-    auto block_num = 0;
+    auto block_num = 0u;
     if(!params.block_num.has_value()) {
         block_num = db.get_block_num_for_trx_id(params.id);
     }
     else {
         block_num = *params.block_num;
     }
+
+    // only transactions in irreversible blocks are cached
+    auto key = std::string();
+    if(responses && block_num <= db.last_irreversible_block_num()) {
+        key = "t" + std::to_string(block_num) + ":" + params.id.str() + (params.raw.has_value() && *params.raw ? ":raw" : "");
+        if(auto r = responses->lookup(key)) {
+            return *r;
+        }
+    }
+
     auto block = db.fetch_block_by_number(block_num);
     EVT_ASSERT(block, unknown_block_exception, "Could not find head block");
 
@@ -1182,7 +1383,11 @@ read_only::get_transaction(const get_transaction_params& params) {
             mv["block_num"] = block_num;
             mv["block_id"]  = block->id();
 
-            return mv;
+            auto r = std::make_shared<const std::string>(fc::json::to_string(mv));
+            if(!key.empty()) {
+                responses->insert(key, r);
+            }
+            return *r;
         }
     }
     EVT_THROW(unknown_transaction_exception, "Cannot find transaction");
@@ -1314,7 +1519,9 @@ read_only::abi_json_to_bin(const read_only::abi_json_to_bin_params& params) cons
     auto action_type = exec_ctx.get_acttype_name(params.action);
 
     try {
-        result.binargs = abi.variant_to_binary(action_type, params.args, exec_ctx, shorten_abi_errors);
+        if(!exec_ctx.variant_to_binary(params.action, params.args, result.binargs)) {
+            result.binargs = abi.variant_to_binary(action_type, params.args, exec_ctx, shorten_abi_errors);
+        }
     }
     EVT_RETHROW_EXCEPTIONS(chain::action_args_exception,
                            "'${args}' is invalid args for action '${action}'. expected '${proto}'",
@@ -1331,7 +1538,9 @@ read_only::abi_bin_to_json(const read_only::abi_bin_to_json_params& params) cons
     auto result      = abi_bin_to_json_result();
     auto action_type = exec_ctx.get_acttype_name(params.action);
 
-    result.args = abi.binary_to_variant(action_type, params.binargs, exec_ctx, shorten_abi_errors);
+    if(!exec_ctx.binary_to_variant(params.action, params.binargs, result.args)) {
+        result.args = abi.binary_to_variant(action_type, params.binargs, exec_ctx, shorten_abi_errors);
+    }
     return result;
 }
 
@@ -1464,5 +1673,18 @@ read_only::get_db_info(const get_db_info_params&) const {
     return db.token_db().stats();
 }
 
+fc::variant
+read_only::get_auth_cache_stats(const get_auth_cache_stats_params&) const {
+    return fc::variant(db.auth_cache().get_stats());
+}
+
+fc::variant
+read_only::get_response_cache_stats(const get_response_cache_stats_params&) const {
+    if(!responses) {
+        return fc::variant(response_cache::stats {});
+    }
+    return fc::variant(responses->get_stats());
+}
+
 }  // namespace chain_apis
 }  // namespace evt
@@ -11,6 +11,7 @@
 #include <evt/chain/transaction.hpp>
 #include <evt/chain/plugin_interface.hpp>
 #include <evt/chain/contracts/abi_serializer.hpp>
+#include <evt/chain_plugin/response_cache.hpp>
 
 #include <fc/static_variant.hpp>
 
@@ -49,11 +50,12 @@ struct resolver_factory;
 class read_only {
 public:
     const controller& db;
-    bool  shorten_abi_errors = true;
+    response_cache*   responses;  // responses of irreversible blocks, null if disabled
+    bool              shorten_abi_errors = true;
 
 public:
-    read_only(const controller& db)
-        : db(db) {}
+    read_only(const controller& db, response_cache* responses = nullptr)
+        : db(db), responses(responses) {}
 
     void set_shorten_abi_errors(bool f) { shorten_abi_errors = f; }
 
@@ -134,6 +136,9 @@ public:
         string block_num_or_id;
     };
     fc::variant get_block(const get_block_params& params) const;
+    // same as get_block but only for irreversible blocks in block log and safe to call from http threads
+    // returns serialized response, which is cached, or empty string when the block is not in block log
+    std::string get_irreversible_block(const get_block_params& params) const;
 
     struct get_block_header_state_params {
         string block_num_or_id;
@@ -148,7 +153,7 @@ public:
         chain::transaction_id_type id;
         optional<bool>             raw;
     };
-    fc::variant get_transaction(const get_transaction_params& params);
+    std::string get_transaction(const get_transaction_params& params);
 
     struct get_trx_id_for_link_id_params {
         bytes link_id;
@@ -168,6 +173,15 @@ public:
 
     using get_db_info_params = empty;
     std::string get_db_info(const get_db_info_params&) const;
+
+    using get_auth_cache_stats_params = empty;
+    fc::variant get_auth_cache_stats(const get_auth_cache_stats_params&) const;
+
+    using get_response_cache_stats_params = empty;
+    fc::variant get_response_cache_stats(const get_response_cache_stats_params&) const;
+
+private:
+    fc::variant block_to_variant(const chain::signed_block& block) const;
 };
 
 class read_write {
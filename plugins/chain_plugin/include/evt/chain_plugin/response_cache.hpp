@@ -0,0 +1,99 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+#pragma once
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <boost/noncopyable.hpp>
+#include <fc/reflect/reflect.hpp>
+
+namespace evt { namespace chain_apis {
+
+/**
+ * Bounded LRU of serialized JSON responses which never change, i.e. of irreversible blocks.
+ *
+ * The cache is bounded by the total size of cached responses, least recently used ones are evicted first.
+ * It's safe to use from http threads.
+ */
+class response_cache : boost::noncopyable {
+public:
+    using response_ptr = std::shared_ptr<const std::string>;
+
+    struct stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t size;
+        uint64_t bytes;
+        uint64_t max_bytes;
+    };
+
+public:
+    response_cache(size_t max_bytes)
+        : max_bytes_(max_bytes) {}
+
+public:
+    bool enabled() const { return max_bytes_ > 0; }
+
+    response_ptr
+    lookup(const std::string& key) {
+        auto lock = std::lock_guard<std::mutex>(mutex_);
+
+        auto it = index_.find(key);
+        if(it == index_.end()) {
+            misses_++;
+            return nullptr;
+        }
+        hits_++;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->second;
+    }
+
+    void
+    insert(const std::string& key, const response_ptr& response) {
+        if(response->size() > max_bytes_) {
+            return;
+        }
+
+        auto lock = std::lock_guard<std::mutex>(mutex_);
+        if(index_.find(key) != index_.end()) {
+            // other thread has cached the same response
+            return;
+        }
+        while(bytes_ + response->size() > max_bytes_) {
+            bytes_ -= lru_.back().second->size();
+            index_.erase(lru_.back().first);
+            lru_.pop_back();
+        }
+
+        lru_.emplace_front(key, response);
+        index_.emplace(key, lru_.begin());
+        bytes_ += response->size();
+    }
+
+    stats
+    get_stats() const {
+        auto lock = std::lock_guard<std::mutex>(mutex_);
+        return stats { hits_, misses_, lru_.size(), bytes_, max_bytes_ };
+    }
+
+private:
+    using lru_list = std::list<std::pair<std::string, response_ptr>>;
+
+    size_t max_bytes_;
+    size_t bytes_ = 0;
+
+    mutable std::mutex                                  mutex_;
+    lru_list                                            lru_;
+    std::unordered_map<std::string, lru_list::iterator> index_;
+
+    uint64_t hits_   = 0;
+    uint64_t misses_ = 0;
+};
+
+}}  // namespace evt::chain_apis
+
+FC_REFLECT(evt::chain_apis::response_cache::stats, (hits)(misses)(size)(bytes)(max_bytes));
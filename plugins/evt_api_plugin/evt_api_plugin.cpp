@@ -29,15 +29,27 @@ evt_api_plugin::set_program_options(options_description&, options_description&)
 void
 evt_api_plugin::plugin_initialize(const variables_map&) {}
 
+// Token database is changed by the main thread, so the calls are posted there
+// while parsing requests and serializing responses stay on http threads
 #define CALL(api_name, api_handle, api_namespace, call_name, http_response_code)                                              \
     {                                                                                                                         \
         std::string("/v1/" #api_name "/" #call_name),                                                                         \
-            [api_handle](string, string body, url_response_callback cb) mutable {                                       \
+            [api_handle](string, string body, url_response_callback cb) mutable {                                             \
                 try {                                                                                                         \
                     if(body.empty())                                                                                          \
                         body = "{}";                                                                                          \
-                    auto result = api_handle.call_name(fc::json::from_string(body).as<api_namespace::call_name##_params>());  \
-                    cb(http_response_code, fc::json::to_string(result));                                                      \
+                    auto params = fc::json::from_string(body).as<api_namespace::call_name##_params>();                        \
+                    app().post(appbase::priority::low, [api_handle, params, body, cb]() mutable {                             \
+                        try {                                                                                                 \
+                            auto result = api_handle.call_name(params);                                                       \
+                            app().get_plugin<http_plugin>().post_http_thread_pool([result, cb] {                              \
+                                cb(http_response_code, fc::json::to_string(result));                                          \
+                            });                                                                                               \
+                        }                                                                                                     \
+                        catch (...) {                                                                                         \
+                            http_plugin::handle_exception(#api_name, #call_name, body, cb);                                   \
+                        }                                                                                                     \
+                    });                                                                                                       \
                 }                                                                                                             \
                 catch (...) {                                                                                                 \
                     http_plugin::handle_exception(#api_name, #call_name, body, cb);                                           \
@@ -54,16 +66,16 @@ evt_api_plugin::plugin_startup() {
     my.reset(new evt_api_plugin_impl(app().get_plugin<chain_plugin>().chain()));
     auto ro_api = app().get_plugin<evt_plugin>().get_read_only_api();
 
-    app().get_plugin<http_plugin>().add_api({EVT_RO_CALL(get_domain, 200),
-                                             EVT_RO_CALL(get_group, 200),
-                                             EVT_RO_CALL(get_token, 200),
-                                             EVT_RO_CALL(get_tokens, 200),
-                                             EVT_RO_CALL(get_fungible, 200),
-                                             EVT_RO_CALL(get_fungible_balance, 200),
-                                             EVT_RO_CALL(get_fungible_psvbonus, 200),
-                                             EVT_RO_CALL(get_suspend, 200),
-                                             EVT_RO_CALL(get_lock, 200),
-                                         });
+    app().get_plugin<http_plugin>().add_thread_safe_api({EVT_RO_CALL(get_domain, 200),
+                                                         EVT_RO_CALL(get_group, 200),
+                                                         EVT_RO_CALL(get_token, 200),
+                                                         EVT_RO_CALL(get_tokens, 200),
+                                                         EVT_RO_CALL(get_fungible, 200),
+                                                         EVT_RO_CALL(get_fungible_balance, 200),
+                                                         EVT_RO_CALL(get_fungible_psvbonus, 200),
+                                                         EVT_RO_CALL(get_suspend, 200),
+                                                         EVT_RO_CALL(get_lock, 200),
+                                                     });
 }
 
 void
@@ -4,9 +4,11 @@
  */
 #include <evt/evt_link_plugin/evt_link_plugin.hpp>
 
+#include <algorithm>
 #include <deque>
 #include <tuple>
 #include <chrono>
+#include <map>
 #include <unordered_map>
 #include <thread>
 
@@ -27,10 +29,11 @@ static appbase::abstract_plugin& _evt_link_plugin = app().register_plugin<evt_li
 
 using evt::chain::bytes;
 using evt::chain::link_id_type;
+using evt::chain::block_id_type;
 using evt::chain::block_state_ptr;
 using evt::chain::transaction_trace_ptr;
 using evt::chain::contracts::evt_link;
-using evt::chain::contracts::everipay;
+using evt::chain::contracts::evt_link_object;
 
 using boost::asio::steady_timer;
 using steady_timer_ptr = std::shared_ptr<steady_timer>;
@@ -44,8 +47,11 @@ struct evt_link_id_hasher {
 
 class evt_link_plugin_impl : public std::enable_shared_from_this<evt_link_plugin_impl> {
 public:
-    using deferred_pair = std::pair<deferred_id, steady_timer_ptr>;
-    enum { kDeferredId = 0, kTimer };
+    struct watcher {
+        deferred_id      id;
+        steady_timer_ptr timer;
+        bool             irreversible;  // responds only after the block of payment is irreversible
+    };
 
 public:
     evt_link_plugin_impl(controller& db)
@@ -54,111 +60,177 @@ public:
 
 public:
     void init();
-    void get_trx_id_for_link_id(const link_id_type& link_id, deferred_id id);
-    void add_and_schedule(const link_id_type& link_id, deferred_id id);
+    void get_trx_id_for_link_id(const link_id_type& link_id, bool irreversible, deferred_id id);
+    void add_and_schedule(const link_id_type& link_id, bool irreversible, deferred_id id);
 
 private:
-    void applied_block(const block_state_ptr& bs);
+    void applied_everipay(const evt_link_object& link_obj);
+    void accepted_block(const block_state_ptr& bs);
+    void irreversible_block(const block_state_ptr& bs);
 
-    template<typename T>
-    void response(const link_id_type& link_id, T&& response_fun);
+    bool has_watcher(const link_id_type& link_id, bool irreversible) const;
+    void response(const link_id_type& link_id, const evt_link_object& link_obj, const block_id_type& block_id, bool irreversible);
 
 public:
     controller& db_;
 
     std::atomic_bool init_{false};
     uint32_t         timeout_;
+    uint32_t         irreversible_timeout_;
 
-    std::unordered_multimap<link_id_type, deferred_pair, evt_link_id_hasher> link_ids_;
+    // watchers by link id, everything here is accessed from the main thread only
+    std::unordered_multimap<link_id_type, watcher, evt_link_id_hasher> link_ids_;
+    // watched links paid in pending blocks by block num, not confirmed until the block is accepted
+    std::unordered_map<uint32_t, std::vector<evt_link_object>> applied_links_;
+    // paid links waiting for their blocks to be irreversible
+    std::map<uint32_t, std::vector<link_id_type>> irreversible_links_;
 
+    std::optional<boost::signals2::scoped_connection> applied_everipay_connection_;
     std::optional<boost::signals2::scoped_connection> accepted_block_connection_;
+    std::optional<boost::signals2::scoped_connection> irreversible_block_connection_;
 };
 
 void
-evt_link_plugin_impl::applied_block(const block_state_ptr& bs) {
-    if(link_ids_.empty()) {
+evt_link_plugin_impl::applied_everipay(const evt_link_object& link_obj) {
+    // the transaction may still fail or the pending block be aborted,
+    // so the payment is only recorded here and confirmed when its block is accepted
+    if(link_ids_.find(link_obj.link_id) == link_ids_.end()) {
+        return;
+    }
+    applied_links_[link_obj.block_num].emplace_back(link_obj);
+}
+
+void
+evt_link_plugin_impl::accepted_block(const block_state_ptr& bs) {
+    if(applied_links_.empty()) {
         return;
     }
 
-    for(auto& trx : bs->trxs) {
-        for(auto& act : trx->packed_trx->get_transaction().actions) {
-            if(act.name != N(everipay)) {
+    auto it = applied_links_.find(bs->block_num);
+    if(it != applied_links_.end()) {
+        for(auto& applied : it->second) {
+            auto link_obj = evt_link_object();
+            try {
+                link_obj = db_.get_link_obj_for_link_id(applied.link_id);
+            }
+            catch(const chain::evt_link_existed_exception&) {
+                // payment was rolled back with its transaction
+                continue;
+            }
+            if(link_obj.block_num != bs->block_num || link_obj.trx_id != applied.trx_id) {
                 continue;
             }
 
-            auto& epact = act.data_as<const everipay&>();
-
-            response(epact.link.get_link_id(), [&] {
-                auto vo         = fc::mutable_variant_object();
-                vo["block_num"] = bs->block_num;
-                vo["block_id"]  = bs->id;
-                vo["trx_id"]    = trx->id;
-                vo["err_code"]  = 0;
+            if(has_watcher(applied.link_id, false)) {
+                response(applied.link_id, link_obj, bs->id, false);
+            }
+            if(has_watcher(applied.link_id, true)) {
+                irreversible_links_[link_obj.block_num].emplace_back(applied.link_id);
+            }
+        }
+    }
 
-                return fc::json::to_string(vo);
-            });
+    // payments recorded in aborted pending blocks are applied again in later blocks
+    for(auto pit = applied_links_.begin(); pit != applied_links_.end();) {
+        if(pit->first <= bs->block_num) {
+            pit = applied_links_.erase(pit);
+            continue;
         }
+        pit++;
     }
 }
 
-template<typename T>
 void
-evt_link_plugin_impl::response(const link_id_type& link_id, T&& response_fun) {
-    auto sz = link_ids_.count(link_id);
-    if(sz == 0) {
-        return;
+evt_link_plugin_impl::irreversible_block(const block_state_ptr& bs) {
+    while(!irreversible_links_.empty() && irreversible_links_.begin()->first <= bs->block_num) {
+        auto link_ids = std::move(irreversible_links_.begin()->second);
+        irreversible_links_.erase(irreversible_links_.begin());
+
+        for(auto& link_id : link_ids) {
+            if(!has_watcher(link_id, true)) {
+                continue;
+            }
+
+            auto link_obj = evt_link_object();
+            try {
+                link_obj = db_.get_link_obj_for_link_id(link_id);
+            }
+            catch(const chain::evt_link_existed_exception&) {
+                // payment was dropped by a fork switch, it's recorded again once applied in new fork
+                continue;
+            }
+            if(link_obj.block_num > bs->block_num) {
+                // payment is included in another block after a fork switch
+                irreversible_links_[link_obj.block_num].emplace_back(link_id);
+                continue;
+            }
+
+            response(link_id, link_obj, db_.get_block_id_for_num(link_obj.block_num), true);
+        }
     }
-    auto json = response_fun();
+}
+
+bool
+evt_link_plugin_impl::has_watcher(const link_id_type& link_id, bool irreversible) const {
+    auto pair = link_ids_.equal_range(link_id);
+    return std::any_of(pair.first, pair.second, [irreversible](auto& w) { return w.second.irreversible == irreversible; });
+}
+
+void
+evt_link_plugin_impl::response(const link_id_type& link_id, const evt_link_object& link_obj, const block_id_type& block_id, bool irreversible) {
+    auto vo         = fc::mutable_variant_object();
+    vo["block_num"] = link_obj.block_num;
+    vo["block_id"]  = block_id;
+    vo["trx_id"]    = link_obj.trx_id;
+    vo["err_code"]  = 0;
+
+    auto json = fc::json::to_string(vo);
     auto wptr = std::weak_ptr<evt_link_plugin_impl>(shared_from_this());
-    boost::asio::post(app().get_io_service(), [wptr, json, link_id] {
+    boost::asio::post(app().get_io_service(), [wptr, json, link_id, irreversible] {
         auto self = wptr.lock();
         if(!self) {
             return;
         }
         auto pair = self->link_ids_.equal_range(link_id);
-        if(pair.first != self->link_ids_.end()) {
-            std::for_each(pair.first, pair.second, [&](auto& it) {
-                app().get_plugin<http_plugin>().set_deferred_response(std::get<kDeferredId>(it.second), 200, json);
-            });
-
-            self->link_ids_.erase(link_id);
-            return;
+        for(auto it = pair.first; it != pair.second;) {
+            if(it->second.irreversible != irreversible) {
+                it++;
+                continue;
+            }
+            it->second.timer->cancel();
+            app().get_plugin<http_plugin>().set_deferred_response(it->second.id, 200, json);
+            it = self->link_ids_.erase(it);
         }
     });
 }
 
 void
-evt_link_plugin_impl::add_and_schedule(const link_id_type& link_id, deferred_id id) {
-    auto it = link_ids_.emplace(link_id, std::make_pair(id, std::make_shared<steady_timer>(app().get_io_service())));
+evt_link_plugin_impl::add_and_schedule(const link_id_type& link_id, bool irreversible, deferred_id id) {
+    auto timer = std::make_shared<steady_timer>(app().get_io_service());
+    link_ids_.emplace(link_id, watcher { id, timer, irreversible });
+
+    auto timeout = irreversible ? irreversible_timeout_ : timeout_;
+    timer->expires_from_now(std::chrono::milliseconds(timeout));
 
-    auto timer = std::get<kTimer>(it->second);
-    timer->expires_from_now(std::chrono::milliseconds(timeout_));
-    
     auto wptr = std::weak_ptr<evt_link_plugin_impl>(shared_from_this());
-    timer->async_wait([wptr, link_id](auto& ec) {
+    timer->async_wait([wptr, link_id, id, timeout](auto& ec) {
         auto self = wptr.lock();
         if(self && ec != boost::asio::error::operation_aborted) {
+            // only the expired watcher is removed, others of the same link may wait longer
             auto pair = self->link_ids_.equal_range(link_id);
-            if(pair.first == self->link_ids_.end()) {
+            auto it   = std::find_if(pair.first, pair.second, [id](auto& w) { return w.second.id == id; });
+            if(it == pair.second) {
                 wlog("Cannot find context for id: ${id}", ("id",link_id));
                 return;
             }
-            
-            auto ids = std::vector<deferred_id>();
-            std::for_each(pair.first, pair.second, [&ids](auto& it) {
-                ids.emplace_back(std::get<kDeferredId>(it.second));
-            });
-
-            self->link_ids_.erase(link_id);
+            self->link_ids_.erase(it);
 
             try {
-                EVT_THROW(chain::exceed_evt_link_watch_time_exception, "Exceed EVT-Link watch time: ${time} ms", ("time",self->timeout_));
+                EVT_THROW(chain::exceed_evt_link_watch_time_exception, "Exceed EVT-Link watch time: ${time} ms", ("time",timeout));
             }
             catch(...) {
-                http_plugin::handle_exception("evt_link", "get_trx_id_for_link_id", "", [&ids](auto code, auto body) {
-                    for(auto id : ids) {
-                        app().get_plugin<http_plugin>().set_deferred_response(id, code, body);
-                    }
+                http_plugin::handle_exception("evt_link", "get_trx_id_for_link_id", "", [id](auto code, auto body) {
+                    app().get_plugin<http_plugin>().set_deferred_response(id, code, body);
                 });
             }
         }
@@ -166,13 +238,19 @@ evt_link_plugin_impl::add_and_schedule(const link_id_type& link_id, deferred_id
 }
 
 void
-evt_link_plugin_impl::get_trx_id_for_link_id(const link_id_type& link_id, deferred_id id) {
+evt_link_plugin_impl::get_trx_id_for_link_id(const link_id_type& link_id, bool irreversible, deferred_id id) {
     // try to fetch from chain first
     try {
         auto obj = db_.get_link_obj_for_link_id(link_id);
         if(obj.block_num > db_.fork_db_head_block_num()) {
-            // block not finalize yet
-            add_and_schedule(link_id, id);
+            // block not finalize yet, payment has been applied before watching
+            add_and_schedule(link_id, irreversible, id);
+            applied_links_[obj.block_num].emplace_back(obj);
+            return;
+        }
+        if(irreversible && obj.block_num > db_.last_irreversible_block_num()) {
+            add_and_schedule(link_id, irreversible, id);
+            irreversible_links_[obj.block_num].emplace_back(link_id);
             return;
         }
 
@@ -185,7 +263,7 @@ evt_link_plugin_impl::get_trx_id_for_link_id(const link_id_type& link_id, deferr
     }
     catch(const chain::evt_link_existed_exception&) {
         // cannot find now, put into map
-        add_and_schedule(link_id, id);
+        add_and_schedule(link_id, irreversible, id);
     }
 }
 
@@ -196,8 +274,14 @@ evt_link_plugin_impl::init() {
     auto& chain_plug = app().get_plugin<chain_plugin>();
     auto& chain      = chain_plug.chain();
 
+    applied_everipay_connection_.emplace(chain.applied_everipay.connect([&](const evt_link_object& link_obj) {
+        applied_everipay(link_obj);
+    }));
     accepted_block_connection_.emplace(chain.accepted_block.connect([&](const chain::block_state_ptr& bs) {
-        applied_block(bs);
+        accepted_block(bs);
+    }));
+    irreversible_block_connection_.emplace(chain.irreversible_block.connect([&](const chain::block_state_ptr& bs) {
+        irreversible_block(bs);
     }));
 }
 
@@ -210,13 +294,15 @@ void
 evt_link_plugin::set_program_options(options_description&, options_description& cfg) {
     cfg.add_options()
         ("evt-link-timeout", bpo::value<uint32_t>()->default_value(5000), "Max time waitting for the deferred request.")
+        ("evt-link-irreversible-timeout", bpo::value<uint32_t>()->default_value(180000), "Max time waitting for the deferred request which waits for irreversible block.")
     ;
 }
 
 void
 evt_link_plugin::plugin_initialize(const variables_map& options) {
     my_ = std::make_shared<evt_link_plugin_impl>(app().get_plugin<chain_plugin>().chain());
-    my_->timeout_ = options.at("evt-link-timeout").as<uint32_t>();
+    my_->timeout_              = options.at("evt-link-timeout").as<uint32_t>();
+    my_->irreversible_timeout_ = options.at("evt-link-irreversible-timeout").as<uint32_t>();
     my_->init();
 }
 
@@ -237,7 +323,13 @@ evt_link_plugin::plugin_startup() {
             auto link_id = link_id_type();
             memcpy(&link_id, b.data(), sizeof(link_id_type));
 
-            my_->get_trx_id_for_link_id(link_id, id);
+            // optional, waits until the block of payment is irreversible instead of accepted
+            auto irreversible = false;
+            if(var.get_object().contains("irreversible")) {
+                irreversible = var["irreversible"].as_bool();
+            }
+
+            my_->get_trx_id_for_link_id(link_id, irreversible, id);
         }
         catch(...) {
             http_plugin::handle_exception("evt_link", "get_trx_id_for_link_id", body, [id](auto code, auto body) {
@@ -251,7 +343,9 @@ evt_link_plugin::plugin_startup() {
 
 void
 evt_link_plugin::plugin_shutdown() {
+    my_->applied_everipay_connection_.reset();
     my_->accepted_block_connection_.reset();
+    my_->irreversible_block_connection_.reset();
     my_.reset();
 }
 
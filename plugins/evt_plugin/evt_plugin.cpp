@@ -164,8 +164,25 @@ read_only::get_tokens(const get_tokens_params& params) {
         EVT_ASSERT(t <= 100, chain::exceed_query_limit_exception, "Exceed limit of max actions return allowed for each query, limit: 100 per query");
     }
 
-    int i = 0;
-    tokendb.read_tokens_range(token_type::token, params.domain, s, [&](auto& key, auto&& value) {
+    // cursor is the name of last token returned and is exclusive
+    auto start = std::string_view();
+    auto last  = token_name();
+    if(params.cursor.has_value() && !params.cursor->empty()) {
+        last  = token_name(*params.cursor);
+        start = std::string_view((const char*)&last, sizeof(last));
+    }
+
+    int  i    = 0;
+    auto next = fc::variant();
+    tokendb.scan_tokens_range(token_type::token, params.domain, start, [&](auto& key, auto& value) {
+        if(!start.empty() && key == start) {
+            return true;
+        }
+        if(s > 0) {
+            s--;
+            return true;
+        }
+
         auto var = fc::variant();
 
         token_def token;
@@ -175,12 +192,16 @@ read_only::get_tokens(const get_tokens_params& params) {
         vars.emplace_back(std::move(var));
 
         if(++i == t) {
+            next = (std::string)token.name;
             return false;
         }
         return true;
     });
 
-    return vars;
+    if(!params.cursor.has_value()) {
+        return vars;
+    }
+    return fc::mutable_variant_object("tokens", std::move(vars))("cursor", std::move(next));
 }
 
 fc::variant
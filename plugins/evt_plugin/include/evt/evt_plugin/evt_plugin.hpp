@@ -48,9 +48,10 @@ public:
     fc::variant get_token(const get_token_params& params);
 
     struct get_tokens_params {
-        domain_name        domain;
-        std::optional<int> skip;
-        std::optional<int> take;
+        domain_name                domain;
+        std::optional<int>         skip;
+        std::optional<int>         take;
+        std::optional<std::string> cursor;  // returned by previous page, empty for the first page
     };
     fc::variant get_tokens(const get_tokens_params& params);
 
@@ -111,7 +112,7 @@ private:
 FC_REFLECT(evt::evt_apis::read_only::get_domain_params, (name));
 FC_REFLECT(evt::evt_apis::read_only::get_group_params, (name));
 FC_REFLECT(evt::evt_apis::read_only::get_token_params, (domain)(name));
-FC_REFLECT(evt::evt_apis::read_only::get_tokens_params, (domain)(skip)(take));
+FC_REFLECT(evt::evt_apis::read_only::get_tokens_params, (domain)(skip)(take)(cursor));
 FC_REFLECT(evt::evt_apis::read_only::get_fungible_params, (id));
 FC_REFLECT(evt::evt_apis::read_only::get_fungible_balance_params, (address)(sym_id));
 FC_REFLECT(evt::evt_apis::read_only::get_fungible_psvbonus_params, (id));
@@ -82,6 +82,7 @@ history_api_plugin::plugin_startup() {
                                                    HISTORY_RO_ASYNC_CALL(get_fungible_ids),
                                                    HISTORY_RO_ASYNC_CALL(get_transaction_actions),
                                                   });
+    app().get_plugin<http_plugin>().add_api({HISTORY_RO_CALL(get_query_stats, 200)}, true /* local only API */);
 }
 
 void
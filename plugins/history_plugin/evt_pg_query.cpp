@@ -6,7 +6,11 @@
 
 #pragma GCC diagnostic ignored "-Wunused-local-typedefs"
 
+#include <algorithm>
+#include <cctype>
 #include <functional>
+#include <iterator>
+#include <limits>
 #include <fmt/format.h>
 #include <libpq-fe.h>
 #include <boost/lexical_cast.hpp>
@@ -84,6 +88,9 @@ const char* call_names[] = {
     "get_transaction_actions"
 };
 
+// upper bounds of latency buckets in milliseconds, slower queries fall into the last bucket
+const uint32_t latency_buckets_ms[] = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000 };
+
 template<typename T>
 int
 response_ok(int id, const T& obj) {
@@ -98,6 +105,26 @@ response_ok<std::string>(int id, const std::string& str) {
     return PG_OK;
 }
 
+// Wraps one page of rows together with the cursor of next page
+// cursor is null when there're no more rows left
+std::string
+make_page(const char* name, const std::string& rows, const std::string& cursor) {
+    if(cursor.empty()) {
+        return fmt::format(fmt(R"({{"{}":{},"cursor":null}})"), name, rows);
+    }
+    return fmt::format(fmt(R"({{"{}":{},"cursor":"{}"}})"), name, rows, cursor);
+}
+
+int64_t
+parse_cursor(const std::string& cursor) {
+    try {
+        return boost::lexical_cast<int64_t>(cursor);
+    }
+    catch(boost::bad_lexical_cast&) {
+        EVT_THROW(chain::invalid_query_cursor_exception, "Invalid cursor: ${c}", ("c",cursor));
+    }
+}
+
 // This function is used to fix the representation of timestamp returned by postgres
 // Use 'T' as the separate the date and time to follow the ISO 8601 standard
 char*
@@ -112,169 +139,317 @@ fix_pg_timestamp(char* str) {
 
 }  // namespace internal
 
+pg_query::pg_query(boost::asio::io_context& io_serv, controller& chain)
+    : latencies_(std::size(internal::call_names))
+    , io_serv_(io_serv)
+    , chain_(chain) {
+    for(auto& l : latencies_) {
+        l.buckets.resize(std::size(internal::latency_buckets_ms) + 1);
+    }
+}
+
 int
-pg_query::connect(const std::string& conn) {
-    conn_ = PQconnectdb(conn.c_str());
+pg_query::connect(const std::string& conn, uint32_t nconns) {
+    EVT_ASSERT(nconns > 0, chain::postgres_connection_exception, "At least one connection is required");
 
-    auto status = PQstatus(conn_);
-    EVT_ASSERT(status == CONNECTION_OK, chain::postgres_connection_exception, "Connect failed");
+    for(auto i = 0u; i < nconns; i++) {
+        auto c  = std::make_unique<connection>(io_serv_);
+        c->conn = PQconnectdb(conn.c_str());
 
-    socket_ = boost::asio::ip::tcp::socket(io_serv_, boost::asio::ip::tcp::v4(), PQsocket(conn_));
+        auto status = PQstatus(c->conn);
+        EVT_ASSERT(status == CONNECTION_OK, chain::postgres_connection_exception, "Connect failed");
+
+        c->socket = boost::asio::ip::tcp::socket(io_serv_, boost::asio::ip::tcp::v4(), PQsocket(c->conn));
+        conns_.emplace_back(std::move(c));
+    }
     return PG_OK;
 }
 
 int
 pg_query::close() {
-    FC_ASSERT(conn_);
-    PQfinish(conn_);
-    conn_ = nullptr;
+    FC_ASSERT(!conns_.empty());
+    for(auto& c : conns_) {
+        PQfinish(c->conn);
+        c->conn = nullptr;
+    }
 
     return PG_OK;
 }
 
 int
 pg_query::prepare_stmts() {
-    for(auto it : internal::prepare_register::instance().stmts) {
-        auto r = PQprepare(conn_, it.first.c_str(), it.second.c_str(), 0, NULL);
-        EVT_ASSERT(PQresultStatus(r) == PGRES_COMMAND_OK, chain::postgres_exec_exception,
-            "Prepare sql failed, sql: ${s}, detail: ${d}", ("s",it.second)("d",PQerrorMessage(conn_)));
-        PQclear(r);
+    for(auto& c : conns_) {
+        for(auto it : internal::prepare_register::instance().stmts) {
+            auto r = PQprepare(c->conn, it.first.c_str(), it.second.c_str(), 0, NULL);
+            EVT_ASSERT(PQresultStatus(r) == PGRES_COMMAND_OK, chain::postgres_exec_exception,
+                "Prepare sql failed, sql: ${s}, detail: ${d}", ("s",it.second)("d",PQerrorMessage(c->conn)));
+            PQclear(r);
+        }
+
+#ifdef LIBPQ_HAS_PIPELINING
+        // pipeline mode only allows extended query protocol, so it's entered after statements are prepared
+        if(PQsetnonblocking(c->conn, 1) == 0 && PQenterPipelineMode(c->conn) == 1) {
+            c->pipeline = true;
+        }
+        else {
+            PQsetnonblocking(c->conn, 0);
+            wlog("Cannot enter pipeline mode for history queries, detail: ${d}", ("d",PQerrorMessage(c->conn)));
+        }
+#endif
     }
     return PG_OK;
 }
 
 int
 pg_query::begin_poll_read() {
-    socket_.async_wait(boost::asio::ip::tcp::socket::wait_type::wait_read, std::bind(&pg_query::poll_read, this));
+    for(auto& c : conns_) {
+        c->socket.async_wait(boost::asio::ip::tcp::socket::wait_type::wait_read, std::bind(&pg_query::poll_read, this, std::ref(*c)));
+    }
     return PG_OK;
 }
 
+read_only::query_stats
+pg_query::get_stats() const {
+    using namespace internal;
+
+    auto stats = read_only::query_stats();
+
+    stats.connections = conns_.size();
+    stats.pipeline    = !conns_.empty() && conns_[0]->pipeline;
+    for(auto& c : conns_) {
+        stats.pending.emplace_back(c->tasks.size());
+    }
+    stats.buckets_ms.assign(std::begin(latency_buckets_ms), std::end(latency_buckets_ms));
+
+    for(auto i = 0u; i < latencies_.size(); i++) {
+        auto& l = latencies_[i];
+        stats.calls.emplace_back(read_only::query_stats::call {
+            call_names[i], l.count, l.count ? l.total_us / (int64_t)l.count : 0, l.max_us, l.buckets });
+    }
+    return stats;
+}
+
 int
-pg_query::queue(int id, int task, std::string&& stmt) {
-    tasks_.emplace(id, task, std::move(stmt));
-    
-    if(!sending_) {
-        send_once();
+pg_query::queue(int id, int task, std::string&& stmt, int take) {
+    assert(!conns_.empty());
+
+    // dispatches to the connection with fewest pending tasks, slow queries only hold up their own connection
+    auto it = std::min_element(conns_.begin(), conns_.end(), [](auto& a, auto& b) {
+        return a->tasks.size() < b->tasks.size();
+    });
+    auto& c = **it;
+
+    c.tasks.emplace_back(id, task, std::move(stmt), take);
+    if(c.pipeline) {
+        return send_pipeline(c);
+    }
+    if(!c.sending) {
+        send_once(c);
     }
     return PG_OK;
 }
 
 int
-pg_query::send_once() {
+pg_query::send_once(connection& c) {
     using namespace internal;
 
-    assert(!tasks_.empty());
-    auto& t = tasks_.front();
+    assert(!c.tasks.empty());
+    auto& t = c.tasks.front();
 
-    auto r = PQsendQuery(conn_, t.stmt.c_str());
+    auto r = PQsendQuery(c.conn, t.stmt.c_str());
     if(r == 1) {
-        sending_ = true;
+        c.sending = true;
         return PG_OK;
     }
 
     try {
         EVT_THROW2(chain::postgres_send_exception,
-            "Send '{}' query command failed, detail: {}", call_names[t.type], PQerrorMessage(conn_));
+            "Send '{}' query command failed, detail: {}", call_names[t.type], PQerrorMessage(c.conn));
     }
     catch(...) {
         app().get_plugin<http_plugin>().handle_async_exception(t.id, "history", call_names[t.type], "");
     }
 
-    tasks_.pop();
-    if(!tasks_.empty()) {
+    c.tasks.pop_front();
+    if(!c.tasks.empty()) {
         // send next one
-        return send_once();
+        return send_once(c);
     }
     return PG_FAIL;
 }
 
 int
-pg_query::poll_read() {
+pg_query::send_pipeline(connection& c) {
     using namespace internal;
 
+#ifdef LIBPQ_HAS_PIPELINING
+    auto& t = c.tasks.back();
+
+    // each query is followed by its own sync point so that a failed query doesn't abort the ones after it
+    auto r = PQsendQueryParams(c.conn, t.stmt.c_str(), 0, NULL, NULL, NULL, NULL, 0);
+    if(r == 1 && PQpipelineSync(c.conn) == 1) {
+        c.syncs++;
+        return flush(c);
+    }
+
+    try {
+        EVT_THROW2(chain::postgres_send_exception,
+            "Send '{}' query command failed, detail: {}", call_names[t.type], PQerrorMessage(c.conn));
+    }
+    catch(...) {
+        app().get_plugin<http_plugin>().handle_async_exception(t.id, "history", call_names[t.type], "");
+    }
+    c.tasks.pop_back();
+#endif
+    return PG_FAIL;
+}
+
+int
+pg_query::flush(connection& c) {
+    if(c.flushing) {
+        return PG_OK;
+    }
+
+    auto r = PQflush(c.conn);
+    if(r == 1) {
+        // output buffer is full, flushes the rest once socket is writable
+        c.flushing = true;
+        c.socket.async_wait(boost::asio::ip::tcp::socket::wait_type::wait_write, [this, &c](auto& ec) {
+            c.flushing = false;
+            if(ec) {
+                return;
+            }
+            flush(c);
+        });
+    }
+    else if(r == -1) {
+        elog("Flush queries to postgres failed, detail: ${d}", ("d",PQerrorMessage(c.conn)));
+        return PG_FAIL;
+    }
+    return PG_OK;
+}
+
+int
+pg_query::resume(const task& t, pg_result const* re) {
+    using namespace internal;
+
+    try {
+        switch(t.type) {
+        case kGetTokens: {
+            get_tokens_resume(t.id, re);
+            break;
+        }
+        case kGetDomains: {
+            get_domains_resume(t.id, re);
+            break;
+        }
+        case kGetGroups: {
+            get_groups_resume(t.id, re);
+            break;
+        }
+        case kGetFungibles: {
+            get_fungibles_resume(t.id, re);
+            break;
+        }
+        case kGetActions: {
+            get_actions_resume(t.id, t.take, re);
+            break;
+        }
+        case kGetFungibleActions: {
+            get_fungible_actions_resume(t.id, re);
+            break;
+        }
+        case kGetFungiblesBalance: {
+            get_fungibles_balance_resume(t.id, re);
+            break;
+        }
+        case kGetTransaction: {
+            get_transaction_resume(t.id, re);
+            break;
+        }
+        case kGetTransactions: {
+            get_transactions_resume(t.id, t.take, re);
+            break;
+        }
+        case kGetFungibleIds: {
+            get_fungible_ids_resume(t.id, t.take, re);
+            break;
+        }
+        case kGetTransactionActions: {
+            get_transaction_actions_resume(t.id, re);
+            break;
+        }
+        };  // switch
+    }
+    catch(...) {
+        app().get_plugin<http_plugin>().handle_async_exception(t.id, "history", call_names[t.type], "");
+    }
+
+    // latency is counted from queuing to response, including waiting behind other tasks
+    auto  us = (fc::time_point::now() - t.start).count();
+    auto& l  = latencies_[t.type];
+
+    l.count    += 1;
+    l.total_us += us;
+    l.max_us    = std::max(l.max_us, us);
+
+    auto b = std::lower_bound(std::begin(latency_buckets_ms), std::end(latency_buckets_ms), (us + 999) / 1000);
+    l.buckets[b - std::begin(latency_buckets_ms)]++;
+
+    return PG_OK;
+}
+
+int
+pg_query::poll_read(connection& c) {
     bool busy = false;
     while(1) {
-        auto r = PQconsumeInput(conn_);
-        EVT_ASSERT(r, chain::postgres_poll_exception, "Poll messages from postgres failed, detail: ${d}", ("d",PQerrorMessage(conn_)));
+        auto r = PQconsumeInput(c.conn);
+        EVT_ASSERT(r, chain::postgres_poll_exception, "Poll messages from postgres failed, detail: ${d}", ("d",PQerrorMessage(c.conn)));
 
-        if(PQisBusy(conn_)) {
+        if(PQisBusy(c.conn)) {
             busy = true;
             break;
         }
 
-        auto re = PQgetResult(conn_);
+        auto re = PQgetResult(c.conn);
         if(re == NULL) {
+            if(c.pipeline && c.syncs > 0) {
+                // end of results of one query in pipeline, more are following
+                continue;
+            }
             break;
         }
 
-        auto t = tasks_.front();
-        tasks_.pop();
-
-        try {
-            switch(t.type) {
-            case kGetTokens: {
-                get_tokens_resume(t.id, re);
-                break;
-            }
-            case kGetDomains: {
-                get_domains_resume(t.id, re);
-                break;
-            }
-            case kGetGroups: {
-                get_groups_resume(t.id, re);
-                break;
-            }
-            case kGetFungibles: {
-                get_fungibles_resume(t.id, re);
-                break;
-            }
-            case kGetActions: {
-                get_actions_resume(t.id, re);
-                break;
-            }
-            case kGetFungibleActions: {
-                get_fungible_actions_resume(t.id, re);
-                break;
-            }
-            case kGetFungiblesBalance: {
-                get_fungibles_balance_resume(t.id, re);
-                break;
-            }
-            case kGetTransaction: {
-                get_transaction_resume(t.id, re);
-                break;
-            }
-            case kGetTransactions: {
-                get_transactions_resume(t.id, re);
-                break;
-            }
-            case kGetFungibleIds: {
-                get_fungible_ids_resume(t.id, re);
-                break;
-            }
-            case kGetTransactionActions: {
-                get_transaction_actions_resume(t.id, re);
-                break;
-            }
-            };  // switch
-        }
-        catch(...) {
-            app().get_plugin<http_plugin>().handle_async_exception(t.id, "history", call_names[t.type], "");
+#ifdef LIBPQ_HAS_PIPELINING
+        if(PQresultStatus(re) == PGRES_PIPELINE_SYNC) {
+            c.syncs--;
+            PQclear(re);
+            continue;
         }
+#endif
 
+        assert(!c.tasks.empty());
+        auto t = std::move(c.tasks.front());
+        c.tasks.pop_front();
+
+        resume(t, re);
         PQclear(re);
     }
 
-    socket_.async_wait(boost::asio::ip::tcp::socket::wait_type::wait_read, std::bind(&pg_query::poll_read, this));
-    if(!busy && !tasks_.empty()) {
+    c.socket.async_wait(boost::asio::ip::tcp::socket::wait_type::wait_read, std::bind(&pg_query::poll_read, this, std::ref(c)));
+    if(c.pipeline) {
+        return PG_OK;
+    }
+
+    if(!busy && !c.tasks.empty()) {
         // send next one
-        if(send_once() == PG_FAIL) {
+        if(send_once(c) == PG_FAIL) {
             // no send
-            sending_ = false;
+            c.sending = false;
         }
     }
     else {
-        sending_ = false;
+        c.sending = false;
     }
     return PG_OK;
 }
@@ -304,7 +479,7 @@ int
 pg_query::get_tokens_resume(int id, pg_result const* r) {
     using namespace internal;
 
-    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get tokens failed, detail: ${s}", ("s",PQerrorMessage(conn_)));
+    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get tokens failed, detail: ${s}", ("s",PQresultErrorMessage(r)));
 
     auto n = PQntuples(r);
     if(n == 0) {
@@ -342,7 +517,7 @@ int
 pg_query::get_domains_resume(int id, pg_result const* r) {
     using namespace internal;
 
-    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get domains failed, detail: ${s}", ("s",PQerrorMessage(conn_)));
+    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get domains failed, detail: ${s}", ("s",PQresultErrorMessage(r)));
 
     auto n = PQntuples(r);
     if(n == 0) {
@@ -375,7 +550,7 @@ int
 pg_query::get_groups_resume(int id, pg_result const* r) {
     using namespace internal;
 
-    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get groups failed, detail: ${s}", ("s",PQerrorMessage(conn_)));
+    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get groups failed, detail: ${s}", ("s",PQresultErrorMessage(r)));
 
     auto n = PQntuples(r);
     if(n == 0) {
@@ -408,7 +583,7 @@ int
 pg_query::get_fungibles_resume(int id, pg_result const* r) {
     using namespace internal;
 
-    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get fungibles failed, detail: ${s}", ("s",PQerrorMessage(conn_)));
+    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get fungibles failed, detail: ${s}", ("s",PQresultErrorMessage(r)));
 
     auto n = PQntuples(r);
     if(n == 0) {
@@ -424,49 +599,50 @@ pg_query::get_fungibles_resume(int id, pg_result const* r) {
     return response_ok(id, results);
 }
 
-auto ga_plan0 = R"sql(SELECT actions.trx_id, name, domain, key, data, transactions.timestamp
+// `global_seq` is used as the continuation cursor: {1} is the comparison matching the order
+auto ga_plan0 = R"sql(SELECT actions.trx_id, name, domain, key, data, transactions.timestamp, actions.global_seq
                       FROM actions
                       JOIN transactions ON actions.trx_id = transactions.trx_id
-                      WHERE domain = $1
+                      WHERE domain = $1 AND actions.global_seq {1} $4
                       ORDER BY actions.global_seq {0}
                       LIMIT $2 OFFSET $3
                       )sql";
 
 // with key filter
-auto ga_plan1 = R"sql(SELECT actions.trx_id, name, domain, key, data, transactions.timestamp
+auto ga_plan1 = R"sql(SELECT actions.trx_id, name, domain, key, data, transactions.timestamp, actions.global_seq
                       FROM actions
                       JOIN transactions ON actions.trx_id = transactions.trx_id
-                      WHERE domain = $1 AND key = $2
+                      WHERE domain = $1 AND key = $2 AND actions.global_seq {1} $5
                       ORDER BY actions.global_seq {0}
                       LIMIT $3 OFFSET $4
                       )sql";
 
 // with name filter
-auto ga_plan2 = R"sql(SELECT actions.trx_id, name, domain, key, data, transactions.timestamp
+auto ga_plan2 = R"sql(SELECT actions.trx_id, name, domain, key, data, transactions.timestamp, actions.global_seq
                       FROM actions
                       JOIN transactions ON actions.trx_id = transactions.trx_id
-                      WHERE domain = $1 AND name = ANY($2)
+                      WHERE domain = $1 AND name = ANY($2) AND actions.global_seq {1} $5
                       ORDER BY actions.global_seq {0}
                       LIMIT $3 OFFSET $4
                       )sql";
 
 // with key and name filter
-auto ga_plan3 = R"sql(SELECT actions.trx_id, name, domain, key, data, transactions.timestamp
+auto ga_plan3 = R"sql(SELECT actions.trx_id, name, domain, key, data, transactions.timestamp, actions.global_seq
                       FROM actions
                       JOIN transactions ON actions.trx_id = transactions.trx_id
-                      WHERE domain = $1 AND key = $2 AND name = ANY($3)
+                      WHERE domain = $1 AND key = $2 AND name = ANY($3) AND actions.global_seq {1} $6
                       ORDER BY actions.global_seq {0}
                       LIMIT $4 OFFSET $5
                       )sql";
 
-PREPARE_SQL_ONCE(ga_plan01, fmt::format(ga_plan0, "DESC"));
-PREPARE_SQL_ONCE(ga_plan02, fmt::format(ga_plan0, "ASC"));
-PREPARE_SQL_ONCE(ga_plan11, fmt::format(ga_plan1, "DESC"));
-PREPARE_SQL_ONCE(ga_plan12, fmt::format(ga_plan1, "ASC"));
-PREPARE_SQL_ONCE(ga_plan21, fmt::format(ga_plan2, "DESC"));
-PREPARE_SQL_ONCE(ga_plan22, fmt::format(ga_plan2, "ASC"));
-PREPARE_SQL_ONCE(ga_plan31, fmt::format(ga_plan3, "DESC"));
-PREPARE_SQL_ONCE(ga_plan32, fmt::format(ga_plan3, "ASC"));
+PREPARE_SQL_ONCE(ga_plan01, fmt::format(ga_plan0, "DESC", "<"));
+PREPARE_SQL_ONCE(ga_plan02, fmt::format(ga_plan0, "ASC", ">"));
+PREPARE_SQL_ONCE(ga_plan11, fmt::format(ga_plan1, "DESC", "<"));
+PREPARE_SQL_ONCE(ga_plan12, fmt::format(ga_plan1, "ASC", ">"));
+PREPARE_SQL_ONCE(ga_plan21, fmt::format(ga_plan2, "DESC", "<"));
+PREPARE_SQL_ONCE(ga_plan22, fmt::format(ga_plan2, "ASC", ">"));
+PREPARE_SQL_ONCE(ga_plan31, fmt::format(ga_plan3, "DESC", "<"));
+PREPARE_SQL_ONCE(ga_plan32, fmt::format(ga_plan3, "ASC", ">"));
 
 int
 pg_query::get_actions_async(int id, const read_only::get_actions_params& params) {
@@ -494,63 +670,72 @@ pg_query::get_actions_async(int id, const read_only::get_actions_params& params)
         j += 4;
     }
 
+    // cursor is the global sequence of last action returned and is exclusive
+    auto c = (j % 2) ? (int64_t)-1 : std::numeric_limits<int64_t>::max();
+    if(params.cursor.has_value() && !params.cursor->empty()) {
+        c = parse_cursor(*params.cursor);
+    }
+
     switch(j) {
     case 0: { // only domain, desc
-        stmt = fmt::format(fmt("EXECUTE ga_plan01 ('{}',{},{});"), (std::string)params.domain, t, s);
+        stmt = fmt::format(fmt("EXECUTE ga_plan01 ('{}',{},{},{});"), (std::string)params.domain, t, s, c);
         break;
     }
     case 1: { // only domain, asc
-        stmt = fmt::format(fmt("EXECUTE ga_plan02 ('{}',{},{});"), (std::string)params.domain, t, s);
+        stmt = fmt::format(fmt("EXECUTE ga_plan02 ('{}',{},{},{});"), (std::string)params.domain, t, s, c);
         break;
     }
     case 2: { // domain + key, desc
-        stmt = fmt::format(fmt("EXECUTE ga_plan11 ('{}','{}',{},{});"), (std::string)params.domain, (std::string)*params.key, t, s);
+        stmt = fmt::format(fmt("EXECUTE ga_plan11 ('{}','{}',{},{},{});"), (std::string)params.domain, (std::string)*params.key, t, s, c);
         break;
     }
     case 3: { // domain + key, asc
-        stmt = fmt::format(fmt("EXECUTE ga_plan12 ('{}','{}',{},{});"), (std::string)params.domain, (std::string)*params.key, t, s);
+        stmt = fmt::format(fmt("EXECUTE ga_plan12 ('{}','{}',{},{},{});"), (std::string)params.domain, (std::string)*params.key, t, s, c);
         break;
     }
     case 4: { // domain + name, desc
         auto names_buf = fmt::memory_buffer();
         format_array_to(names_buf, std::begin(params.names), std::end(params.names));
 
-        stmt = fmt::format(fmt("EXECUTE ga_plan21 ('{}','{}',{},{});"), (std::string)params.domain, fmt::to_string(names_buf), t, s);
+        stmt = fmt::format(fmt("EXECUTE ga_plan21 ('{}','{}',{},{},{});"), (std::string)params.domain, fmt::to_string(names_buf), t, s, c);
         break;
     }
     case 5: { // domain + name, asc
         auto names_buf = fmt::memory_buffer();
         format_array_to(names_buf, std::begin(params.names), std::end(params.names));
 
-        stmt = fmt::format(fmt("EXECUTE ga_plan22 ('{}','{}',{},{});"), (std::string)params.domain, fmt::to_string(names_buf), t, s);
+        stmt = fmt::format(fmt("EXECUTE ga_plan22 ('{}','{}',{},{},{});"), (std::string)params.domain, fmt::to_string(names_buf), t, s, c);
         break;
     }
     case 6: { // domain + key + name, desc
         auto names_buf = fmt::memory_buffer();
         format_array_to(names_buf, std::begin(params.names), std::end(params.names));
 
-        stmt = fmt::format(fmt("EXECUTE ga_plan31 ('{}','{}','{}',{},{});"), (std::string)params.domain, (std::string)*params.key, fmt::to_string(names_buf), t, s);
+        stmt = fmt::format(fmt("EXECUTE ga_plan31 ('{}','{}','{}',{},{},{});"), (std::string)params.domain, (std::string)*params.key, fmt::to_string(names_buf), t, s, c);
         break;
     }
     case 7: { // domain + key + name, asc
         auto names_buf = fmt::memory_buffer();
         format_array_to(names_buf, std::begin(params.names), std::end(params.names));
 
-        stmt = fmt::format(fmt("EXECUTE ga_plan32 ('{}','{}','{}',{},{});"), (std::string)params.domain, (std::string)*params.key, fmt::to_string(names_buf), t, s);
+        stmt = fmt::format(fmt("EXECUTE ga_plan32 ('{}','{}','{}',{},{},{});"), (std::string)params.domain, (std::string)*params.key, fmt::to_string(names_buf), t, s, c);
         break;
     }
     };  // switch
 
-    return queue(id, kGetActions, std::move(stmt));
+    return queue(id, kGetActions, std::move(stmt), params.cursor.has_value() ? t : 0);
 }
 
 int
-pg_query::get_actions_resume(int id, pg_result const* r) {
+pg_query::get_actions_resume(int id, int take, pg_result const* r) {
     using namespace internal;
 
-    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get actions failed, detail: ${s}", ("s",PQerrorMessage(conn_)));
+    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get actions failed, detail: ${s}", ("s",PQresultErrorMessage(r)));
     auto n = PQntuples(r);
     if(n == 0) {
+        if(take > 0) {
+            return response_ok(id, make_page("actions", "[]", std::string()));
+        }
         return response_ok(id, std::string("[]")); // return empty
     }
 
@@ -573,6 +758,10 @@ pg_query::get_actions_resume(int id, pg_result const* r) {
     }
     fmt::format_to(builder, "]");
 
+    if(take > 0) {
+        auto cursor = (n < take) ? std::string() : std::string(PQgetvalue(r, n - 1, 6));
+        return response_ok(id, make_page("actions", fmt::to_string(builder), cursor));
+    }
     return response_ok(id, fmt::to_string(builder));
 }
 
@@ -661,7 +850,7 @@ int
 pg_query::get_fungible_actions_resume(int id, pg_result const* r) {
     using namespace internal;
 
-    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get fungible actions failed, detail: ${s}", ("s",PQerrorMessage(conn_)));
+    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get fungible actions failed, detail: ${s}", ("s",PQresultErrorMessage(r)));
 
     auto n = PQntuples(r);
     if(n == 0) {
@@ -717,7 +906,7 @@ pg_query::get_fungibles_balance_resume(int id, pg_result const* r) {
     using namespace boost::algorithm;
     using namespace chain;
 
-    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get transaction failed, detail: ${s}", ("s",PQerrorMessage(conn_)));
+    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get transaction failed, detail: ${s}", ("s",PQresultErrorMessage(r)));
 
     auto n = PQntuples(r);
     if(n == 0) {
@@ -761,7 +950,7 @@ int
 pg_query::get_transaction_resume(int id, pg_result const* r) {
     using namespace internal;
 
-    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get transaction failed, detail: ${s}", ("s",PQerrorMessage(conn_)));
+    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get transaction failed, detail: ${s}", ("s",PQresultErrorMessage(r)));
 
     auto n = PQntuples(r);
     if(n == 0) {
@@ -795,8 +984,20 @@ pg_query::get_transaction_resume(int id, pg_result const* r) {
     EVT_THROW(chain::unknown_transaction_exception, "Cannot find transaction: ${t}", ("t", trx_id));
 }
 
-PREPARE_SQL_ONCE(gtrxs_plan0, "SELECT block_num, trx_id FROM transactions WHERE keys && $1 ORDER BY timestamp DESC LIMIT $2 OFFSET $3;")
-PREPARE_SQL_ONCE(gtrxs_plan1, "SELECT block_num, trx_id FROM transactions WHERE keys && $1 ORDER BY timestamp ASC  LIMIT $2 OFFSET $3;")
+// (timestamp, trx_id) is used as the continuation cursor, timestamp is in milliseconds
+// {1} is the comparison matching the order
+auto gtrxs_plan = R"sql(SELECT block_num, trx_id, (extract(epoch from timestamp) * 1000)::bigint
+                        FROM transactions
+                        WHERE
+                            keys && $1
+                            AND timestamp {1}= to_timestamp($4::float8 / 1000)
+                            AND (timestamp {1} to_timestamp($4::float8 / 1000) OR trx_id {1} $5)
+                        ORDER BY timestamp {0}, trx_id {0}
+                        LIMIT $2 OFFSET $3
+                        )sql";
+
+PREPARE_SQL_ONCE(gtrxs_plan0, fmt::format(gtrxs_plan, "DESC", "<"));
+PREPARE_SQL_ONCE(gtrxs_plan1, fmt::format(gtrxs_plan, "ASC", ">"));
 
 int
 pg_query::get_transactions_async(int id, const read_only::get_transactions_params& params) {
@@ -814,25 +1015,44 @@ pg_query::get_transactions_async(int id, const read_only::get_transactions_param
     auto keys_buf = fmt::memory_buffer();
     format_array_to(keys_buf, std::begin(params.keys), std::end(params.keys));
 
+    auto use_plan0 = params.dire.has_value() && *params.dire == direction::asc;
+
+    // cursor is formatted as '<timestamp>-<trx_id>' of last transaction returned and is exclusive
+    auto ts  = std::string(use_plan0 ? "infinity" : "-infinity");
+    auto tid = std::string();
+    if(params.cursor.has_value() && !params.cursor->empty()) {
+        auto& cursor = *params.cursor;
+        auto  p      = cursor.find('-');
+        EVT_ASSERT(p != std::string::npos, chain::invalid_query_cursor_exception, "Invalid cursor: ${c}", ("c",cursor));
+
+        ts  = std::to_string(parse_cursor(cursor.substr(0, p)));
+        tid = cursor.substr(p + 1);
+        EVT_ASSERT(tid.size() == 64 && std::all_of(tid.cbegin(), tid.cend(), [](auto c) { return std::isxdigit((unsigned char)c); }),
+            chain::invalid_query_cursor_exception, "Invalid cursor: ${c}", ("c",cursor));
+    }
+
     auto stmt = std::string();
-    if(params.dire.has_value() && *params.dire == direction::asc) {
-        stmt = fmt::format(fmt("EXECUTE gtrxs_plan0('{}',{},{});"), fmt::to_string(keys_buf), t, s);
+    if(use_plan0) {
+        stmt = fmt::format(fmt("EXECUTE gtrxs_plan0('{}',{},{},'{}','{}');"), fmt::to_string(keys_buf), t, s, ts, tid);
     }
     else {
-        stmt = fmt::format(fmt("EXECUTE gtrxs_plan1('{}',{},{});"), fmt::to_string(keys_buf), t, s);
+        stmt = fmt::format(fmt("EXECUTE gtrxs_plan1('{}',{},{},'{}','{}');"), fmt::to_string(keys_buf), t, s, ts, tid);
     }
 
-    return queue(id, kGetTransactions, std::move(stmt));
+    return queue(id, kGetTransactions, std::move(stmt), params.cursor.has_value() ? t : 0);
 }
 
 int
-pg_query::get_transactions_resume(int id, pg_result const* r) {
+pg_query::get_transactions_resume(int id, int take, pg_result const* r) {
     using namespace internal;
 
-    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get transaction failed, detail: ${s}", ("s",PQerrorMessage(conn_)));
+    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get transaction failed, detail: ${s}", ("s",PQresultErrorMessage(r)));
 
     auto n = PQntuples(r);
     if(n == 0) {
+        if(take > 0) {
+            return response_ok(id, make_page("transactions", "[]", std::string()));
+        }
         return response_ok(id, std::string("[]")); // return empty
     }
 
@@ -862,10 +1082,18 @@ pg_query::get_transactions_resume(int id, pg_result const* r) {
             }
         }
     }    
+
+    if(take > 0) {
+        auto cursor = std::string();
+        if(n >= take) {
+            cursor = fmt::format(fmt("{}-{}"), PQgetvalue(r, n - 1, 2), PQgetvalue(r, n - 1, 1));
+        }
+        return response_ok(id, make_page("transactions", fc::json::to_string(results), cursor));
+    }
     return response_ok(id, results);
 }
 
-PREPARE_SQL_ONCE(gfi_plan, "SELECT sym_id FROM fungibles ORDER BY sym_id ASC LIMIT $1 OFFSET $2;");
+PREPARE_SQL_ONCE(gfi_plan, "SELECT sym_id FROM fungibles WHERE sym_id > $3 ORDER BY sym_id ASC LIMIT $1 OFFSET $2;");
 
 int
 pg_query::get_fungible_ids_async(int id, const read_only::get_fungible_ids_params& params) {
@@ -880,18 +1108,27 @@ pg_query::get_fungible_ids_async(int id, const read_only::get_fungible_ids_param
         EVT_ASSERT(t <= 100, chain::exceed_query_limit_exception, "Exceed limit of max actions return allowed for each query, limit: 100 per query");
     }
 
-    auto stmt = fmt::format(fmt("EXECUTE gfi_plan({},{});"), t, s);
-    return queue(id, kGetFungibleIds, std::move(stmt));
+    // cursor is the last sym id returned and is exclusive
+    auto c = (int64_t)-1;
+    if(params.cursor.has_value() && !params.cursor->empty()) {
+        c = parse_cursor(*params.cursor);
+    }
+
+    auto stmt = fmt::format(fmt("EXECUTE gfi_plan({},{},{});"), t, s, c);
+    return queue(id, kGetFungibleIds, std::move(stmt), params.cursor.has_value() ? t : 0);
 }
 
 int
-pg_query::get_fungible_ids_resume(int id, pg_result const* r) {
+pg_query::get_fungible_ids_resume(int id, int take, pg_result const* r) {
     using namespace internal;
 
-    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get fungible ids failed, detail: ${s}", ("s",PQerrorMessage(conn_)));
+    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get fungible ids failed, detail: ${s}", ("s",PQresultErrorMessage(r)));
 
     auto n = PQntuples(r);
     if(n == 0) {
+        if(take > 0) {
+            return response_ok(id, make_page("ids", "[]", std::string()));
+        }
         return response_ok(id, std::string("[]")); // return empty
     }
 
@@ -905,6 +1142,10 @@ pg_query::get_fungible_ids_resume(int id, pg_result const* r) {
     }
     fmt::format_to(buf, "]");
 
+    if(take > 0) {
+        auto cursor = (n < take) ? std::string() : std::string(PQgetvalue(r, n - 1, 0));
+        return response_ok(id, make_page("ids", fmt::to_string(buf), cursor));
+    }
     return response_ok(id, fmt::to_string(buf));
 }
 
@@ -927,7 +1168,7 @@ int
 pg_query::get_transaction_actions_resume(int id, pg_result const* r) {
     using namespace internal;
 
-    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get transaction actions failed, detail: ${s}", ("s",PQerrorMessage(conn_)));
+    EVT_ASSERT(PQresultStatus(r) == PGRES_TUPLES_OK, chain::postgres_query_exception, "Get transaction actions failed, detail: ${s}", ("s",PQresultErrorMessage(r)));
 
     auto n = PQntuples(r);
     if(n == 0) {
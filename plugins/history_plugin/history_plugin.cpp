@@ -13,9 +13,9 @@ static appbase::abstract_plugin& _history_plugin = app().register_plugin<history
 
 class history_plugin_impl {
 public:
-    history_plugin_impl()
+    history_plugin_impl(uint32_t connections)
         : pg_query_(app().get_io_service(), app().get_plugin<chain_plugin>().chain()) {
-        pg_query_.connect(app().get_plugin<postgres_plugin>().connstr());
+        pg_query_.connect(app().get_plugin<postgres_plugin>().connstr(), connections);
         pg_query_.prepare_stmts();
         pg_query_.begin_poll_read();
     }
@@ -33,16 +33,22 @@ history_plugin::~history_plugin() {}
 
 void
 history_plugin::set_program_options(options_description& cli, options_description& cfg) {
+    cfg.add_options()
+        ("history-connections", bpo::value<uint32_t>()->default_value(4),
+            "Number of postgres connections used by history APIs, queries are dispatched to the least busy one")
+        ;
 }
 
 void
 history_plugin::plugin_initialize(const variables_map& options) {
+    connections_ = options.at("history-connections").as<uint32_t>();
+    EVT_ASSERT(connections_ > 0, chain::plugin_config_exception, "history-connections should be greater than 0");
 }
 
 void
 history_plugin::plugin_startup() {
     if(app().get_plugin<postgres_plugin>().enabled()) {
-        my_.reset(new history_plugin_impl());
+        my_.reset(new history_plugin_impl(connections_));
     }
     else {
         wlog("evt::postgres_plugin configured, but no --postgres-uri specified.");
@@ -133,4 +139,11 @@ read_only::get_transaction_actions_async(int id, const get_transaction_actions_p
     plugin_.my_->pg_query_.get_transaction_actions_async(id, params);
 }
 
+read_only::query_stats
+read_only::get_query_stats(const get_query_stats_params&) const {
+    EVT_ASSERT(plugin_.my_, chain::postgres_not_enabled_exception, "Postgres plugin is not enabled.");
+
+    return plugin_.my_->pg_query_.get_stats();
+}
+
 }}  // namespace evt::history_apis
@@ -3,8 +3,10 @@
  *  @copyright defined in evt/LICENSE.txt
  */
 #pragma once
-#include <queue>
+#include <deque>
+#include <memory>
 #include <string>
+#include <vector>
 #include <boost/noncopyable.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
@@ -36,25 +38,52 @@ class pg_query : boost::noncopyable {
 private:
     struct task {
     public:
-        task(int id, int type, std::string&& stmt)
-            : id(id), type(type), stmt(std::move(stmt)) {}
+        task(int id, int type, std::string&& stmt, int take)
+            : id(id), type(type), take(take), stmt(std::move(stmt)), start(fc::time_point::now()) {}
 
     public:
-        int         id;
-        int         type;
-        std::string stmt;
+        int            id;
+        int            type;
+        int            take;  // page size when a continuation cursor is requested, otherwise 0
+        std::string    stmt;
+        fc::time_point start;
+    };
+
+    // One libpq connection, results are returned in the same order as tasks are sent
+    struct connection : boost::noncopyable {
+    public:
+        connection(boost::asio::io_context& io_serv)
+            : socket(io_serv) {}
+
+    public:
+        pg_conn* conn     = nullptr;
+        bool     pipeline = false;  // in pipeline mode all tasks are sent at once without waiting results
+        bool     sending  = false;  // not in pipeline mode: front task is sent and waiting for result
+        bool     flushing = false;  // in pipeline mode: waiting for socket to be writable to flush queries
+        uint32_t syncs    = 0;      // in pipeline mode: sync points not yet returned
+
+        std::deque<task>             tasks;
+        boost::asio::ip::tcp::socket socket;
+    };
+
+    struct latency {
+        uint64_t              count    = 0;
+        int64_t               total_us = 0;
+        int64_t               max_us   = 0;
+        std::vector<uint64_t> buckets;
     };
 
 public:
-    pg_query(boost::asio::io_context& io_serv, controller& chain)
-        : conn_(nullptr), sending_(false), io_serv_(io_serv), chain_(chain), socket_(io_serv) {}
+    pg_query(boost::asio::io_context& io_serv, controller& chain);
 
 public:
-    int connect(const std::string& conn);
+    int connect(const std::string& conn, uint32_t nconns);
     int close();
     int prepare_stmts();
     int begin_poll_read();
 
+    read_only::query_stats get_stats() const;
+
 public:
     int get_tokens_async(int id, const read_only::get_tokens_params& params);
     int get_tokens_resume(int id, pg_result const*);
@@ -69,7 +98,7 @@ public:
     int get_fungibles_resume(int id, pg_result const*);
 
     int get_actions_async(int id, const read_only::get_actions_params& params);
-    int get_actions_resume(int id, pg_result const*);
+    int get_actions_resume(int id, int take, pg_result const*);
 
     int get_fungible_actions_async(int id, const read_only::get_fungible_actions_params& params);
     int get_fungible_actions_resume(int id, pg_result const*);
@@ -81,27 +110,28 @@ public:
     int get_transaction_resume(int id, pg_result const*);
 
     int get_transactions_async(int id, const read_only::get_transactions_params& params);
-    int get_transactions_resume(int id, pg_result const*);
+    int get_transactions_resume(int id, int take, pg_result const*);
 
     int get_fungible_ids_async(int id, const read_only::get_fungible_ids_params& params);
-    int get_fungible_ids_resume(int id, pg_result const*);
+    int get_fungible_ids_resume(int id, int take, pg_result const*);
 
     int get_transaction_actions_async(int id, const read_only::get_transaction_actions_params& params);
     int get_transaction_actions_resume(int id, pg_result const*);
 
 private:
-    int queue(int id, int task, std::string&& stmt);
-    int poll_read();
-    int send_once();
+    int queue(int id, int task, std::string&& stmt, int take = 0);
+    int poll_read(connection& c);
+    int send_once(connection& c);
+    int send_pipeline(connection& c);
+    int flush(connection& c);
+    int resume(const task& t, pg_result const* r);
 
 private:
-    pg_conn* conn_;
+    std::vector<std::unique_ptr<connection>> conns_;
+    std::vector<latency>                     latencies_;  // indexed by task type
 
-    bool                         sending_;
-    std::queue<task>             tasks_;
-    boost::asio::io_context&     io_serv_;
-    chain::controller&           chain_;
-    boost::asio::ip::tcp::socket socket_;
+    boost::asio::io_context& io_serv_;
+    chain::controller&       chain_;
 };
 
 }  // namespace evt
\ No newline at end of file
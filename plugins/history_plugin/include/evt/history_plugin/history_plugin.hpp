@@ -60,6 +60,7 @@ public:
         optional<fc::enum_type<uint8_t, direction>> dire;
         optional<int>                               skip;
         optional<int>                               take;
+        optional<std::string>                       cursor;  // returned by previous page, empty for the first page
     };
     void get_actions_async(int id, const get_actions_params& params);
 
@@ -87,18 +88,38 @@ public:
         optional<fc::enum_type<uint8_t, direction>> dire;
         optional<int>                               skip;
         optional<int>                               take;
+        optional<std::string>                       cursor;  // returned by previous page, empty for the first page
     };
     void get_transactions_async(int id, const get_transactions_params& params);
 
     struct get_fungible_ids_params {
-        optional<int> skip;
-        optional<int> take;
+        optional<int>         skip;
+        optional<int>         take;
+        optional<std::string> cursor;  // returned by previous page, empty for the first page
     };
     void get_fungible_ids_async(int id, const get_fungible_ids_params& params);
 
     using get_transaction_actions_params = get_transaction_params;
     void get_transaction_actions_async(int id, const get_transaction_actions_params& params);
 
+    struct query_stats {
+        struct call {
+            std::string           name;
+            uint64_t              count;
+            int64_t               avg_us;
+            int64_t               max_us;
+            std::vector<uint64_t> buckets;  // counts of queries within each bound of `buckets_ms`, the last one is unbounded
+        };
+
+        uint32_t              connections;
+        bool                  pipeline;
+        std::vector<uint32_t> pending;  // pending queries of each connection
+        std::vector<uint32_t> buckets_ms;
+        std::vector<call>     calls;
+    };
+    using get_query_stats_params = chain_apis::empty;
+    query_stats get_query_stats(const get_query_stats_params&) const;
+
 private:
     const history_plugin& plugin_;
 };
@@ -123,6 +144,7 @@ public:
 
 private:
     std::unique_ptr<class history_plugin_impl> my_;
+    uint32_t                                   connections_;
     friend class history_apis::read_only;
 };
 
@@ -131,9 +153,11 @@ private:
 FC_REFLECT_ENUM(evt::history_apis::direction, (asc)(desc));
 FC_REFLECT(evt::history_apis::read_only::get_params, (keys));
 FC_REFLECT(evt::history_apis::read_only::get_tokens_params, (keys)(domain));
-FC_REFLECT(evt::history_apis::read_only::get_actions_params, (domain)(key)(dire)(names)(skip)(take));
+FC_REFLECT(evt::history_apis::read_only::get_actions_params, (domain)(key)(dire)(names)(skip)(take)(cursor));
 FC_REFLECT(evt::history_apis::read_only::get_fungible_actions_params, (sym_id)(dire)(addr)(skip)(take));
 FC_REFLECT(evt::history_apis::read_only::get_fungibles_balance_params, (addr));
 FC_REFLECT(evt::history_apis::read_only::get_transaction_params, (id));
-FC_REFLECT(evt::history_apis::read_only::get_transactions_params, (keys)(dire)(skip)(take));
-FC_REFLECT(evt::history_apis::read_only::get_fungible_ids_params, (skip)(take));
+FC_REFLECT(evt::history_apis::read_only::get_transactions_params, (keys)(dire)(skip)(take)(cursor));
+FC_REFLECT(evt::history_apis::read_only::get_fungible_ids_params, (skip)(take)(cursor));
+FC_REFLECT(evt::history_apis::read_only::query_stats::call, (name)(count)(avg_us)(max_us)(buckets));
+FC_REFLECT(evt::history_apis::read_only::query_stats, (connections)(pipeline)(pending)(buckets_ms)(calls));
@@ -5,7 +5,9 @@
 #include <evt/http_plugin/http_plugin.hpp>
 
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <thread>
 #include <type_traits>
 #include <regex>
@@ -71,7 +73,7 @@ struct asio_with_stub_log : public websocketpp::config::asio {
 
     typedef base::rng_type rng_type;
 
-    static bool const enable_multithreading = false;
+    static bool const enable_multithreading = true;
 
     struct transport_config : public base::transport_config {
         typedef type::concurrency_type concurrency_type;
@@ -81,7 +83,7 @@ struct asio_with_stub_log : public websocketpp::config::asio {
         typedef type::response_type    response_type;
         typedef TSOCKET                socket_type;
 
-        static bool const enable_multithreading = false;
+        static bool const enable_multithreading = true;
     };
 
     typedef TENDPOINT<transport_config> transport_type;
@@ -112,7 +114,9 @@ public:
 public:
     map<string, url_handler>          url_handlers;
     map<string, url_handler>          url_local_handlers;
+    map<string, url_handler>          url_thread_safe_handlers;
     map<string, url_deferred_handler> url_deferred_handlers;
+    std::shared_mutex                 handlers_mutex;  // handlers are looked up from http threads
     optional<tcp::endpoint>           listen_endpoint;
     string                            access_control_allow_origin;
     string                            access_control_allow_headers;
@@ -124,14 +128,16 @@ public:
     vector<http_connection_ptr_type>  http_conns;
     vector<https_connection_ptr_type> https_conns;
 
-    size_t http_conn_index  = 0;
-    size_t https_conn_index = 0;
-    size_t http_conn_count  = 0;
-    size_t https_conn_count = 0;
+    size_t     http_conn_index  = 0;
+    size_t     https_conn_index = 0;
+    size_t     http_conn_count  = 0;
+    size_t     https_conn_count = 0;
+    std::mutex conns_mutex;  // deferred connections are allocated and released from http threads
 
     websocket_server_type server;
 
-    optional<std::thread>                    server_thread;
+    uint16_t                                 thread_pool_size = 2;
+    vector<std::thread>                      server_threads;
     std::shared_ptr<boost::asio::io_context> server_ioc;
     optional<io_work_t>                      server_ioc_work;
     std::atomic<int64_t>                     bytes_in_flight{0};
@@ -253,6 +259,7 @@ public:
     template <typename T>
     deferred_id
     alloc_deferred_id(typename websocketpp::server<T>::connection_ptr con) {
+        auto lock = std::lock_guard<std::mutex>(conns_mutex);
         if(http_conn_count + https_conn_count >= max_deferred_connection_size) {
             EVT_THROW2(chain::exceed_deferred_request, "Exceed max allowed deferred connections, max: {}", max_deferred_connection_size);
         }
@@ -302,6 +309,31 @@ public:
         return true;
     }
 
+    template<typename H>
+    const H*
+    find_handler(const map<string, H>& handlers, const string& resource) {
+        auto lock = std::shared_lock<std::shared_mutex>(handlers_mutex);
+        auto it   = handlers.find(resource);
+        return it != handlers.end() ? &it->second : nullptr;
+    }
+
+    template <class T>
+    url_response_callback
+    make_response_callback(typename websocketpp::server<T>::connection_ptr con) {
+        return [this, ioc = this->server_ioc, con](auto code, auto response_body) {
+            this->bytes_in_flight += response_body.size();
+            boost::asio::post(*ioc, [this, response_body{std::move(response_body)}, con, code]() {
+                size_t body_size = response_body.size();
+                if(!this->http_no_response) {
+                    con->set_body(std::move(response_body));
+                }
+                con->set_status(websocketpp::http::status_code::value(code));
+                con->send_http_response();
+                this->bytes_in_flight -= body_size;
+            });
+        };
+    }
+
     template <class T>
     void
     handle_http_request(typename websocketpp::server<T>::connection_ptr con) {
@@ -345,27 +377,31 @@ public:
             auto resource = con->get_uri()->get_resource();
 
             {
-                auto handler_itr = url_handlers.find(resource);
-                if(handler_itr != url_handlers.cend()) {
+                // thread-safe handlers run right here on the http thread
+                auto handler = find_handler(url_thread_safe_handlers, resource);
+                if(handler) {
+                    con->defer_http_response();
+                    try {
+                        (*handler)(resource, body, make_response_callback<T>(con));
+                    }
+                    catch(...) {
+                        handle_exception<T>(con);
+                        con->send_http_response();
+                    }
+                    return;
+                }
+            }
+
+            {
+                auto handler = find_handler(url_handlers, resource);
+                if(handler) {
                     con->defer_http_response();
                     bytes_in_flight += body.size();
                     app().post(appbase::priority::low,
-                        [this, ioc = this->server_ioc, handler_itr, resource{std::move(resource)}, body{std::move(body)}, con] {
+                        [this, handler, resource{std::move(resource)}, body{std::move(body)}, con] {
                             this->bytes_in_flight -= body.size();
                             try {
-                                handler_itr->second(resource, body,
-                                    [this, ioc{std::move(ioc)}, con](auto code, auto response_body) {
-                                        this->bytes_in_flight += response_body.size();
-                                        boost::asio::post(*ioc, [this, response_body{std::move(response_body)}, con, code]() {
-                                            size_t body_size = response_body.size();
-                                            if(!this->http_no_response) {
-                                                con->set_body(std::move(response_body));
-                                            }
-                                            con->set_status(websocketpp::http::status_code::value(code));
-                                            con->send_http_response();
-                                            this->bytes_in_flight -= body_size;
-                                        });
-                                    });
+                                (*handler)(resource, body, make_response_callback<T>(con));
                             }
                             catch(...) {
                                 handle_exception<T>(con);
@@ -378,8 +414,8 @@ public:
 
             if constexpr (!std::is_same_v<T, local_config>) {
                 // deferred connection
-                auto deferred_handler_it = url_deferred_handlers.find(resource);
-                if(deferred_handler_it != url_deferred_handlers.end()) {
+                auto deferred_handler = find_handler(url_deferred_handlers, resource);
+                if(deferred_handler) {
                     auto id = alloc_deferred_id<T>(con); 
 
                     con->defer_http_response();
@@ -390,10 +426,10 @@ public:
 
                     bytes_in_flight += body.size();
                     app().post(appbase::priority::low,
-                        [this, deferred_handler_it, resource{std::move(resource)}, body{std::move(body)}, con, id]() {
+                        [this, deferred_handler, resource{std::move(resource)}, body{std::move(body)}, con, id]() {
                             this->bytes_in_flight -= body.size();
                             try {
-                                deferred_handler_it->second(resource, body, id);
+                                (*deferred_handler)(resource, body, id);
                             }
                             catch(...) {
                                 handle_exception<T>(con);
@@ -405,10 +441,10 @@ public:
             }
             else {
                 // local unix socket connection
-                auto handler_itr = url_local_handlers.find(resource);
-                if(handler_itr != url_local_handlers.end()) {
+                auto handler = find_handler(url_local_handlers, resource);
+                if(handler) {
                     con->defer_http_response();
-                    handler_itr->second(resource, body, [this, con](auto code, auto&& body) {
+                    (*handler)(resource, body, [this, con](auto code, auto&& body) {
                         con->set_status(websocketpp::http::status_code::value(code));
                         if(!http_no_response) {
                             con->set_body(std::move(body));
@@ -431,31 +467,35 @@ public:
         }
     }
 
+    // visitor is called without holding the lock, the connection is released afterwards if it's still in the slot
+    template<typename CONS, typename FUNC>
+    void
+    visit_connection(CONS& conns, size_t& count, size_t index, FUNC&& vistor) {
+        auto lock = std::unique_lock<std::mutex>(conns_mutex);
+        FC_ASSERT(index < max_deferred_connection_size);
+        auto con = conns[index];
+        FC_ASSERT(con != nullptr);
+        lock.unlock();
+
+        if(!vistor(con)) {
+            lock.lock();
+            if(conns[index] == con) {
+                conns[index] = nullptr;
+                count--;
+            }
+        }
+    }
+
     template<typename FUNC>
     void
     visit_connection(deferred_id id, FUNC&& vistor) {
         if((id & (1 << 31)) == 0) {
             // http
-            FC_ASSERT(id < max_deferred_connection_size);
-            auto con = http_conns[id];
-            FC_ASSERT(con != nullptr);
-
-            if(!vistor(con)) {
-                http_conns[id] = nullptr;
-                http_conn_count--;
-            }
+            visit_connection(http_conns, http_conn_count, id, std::forward<FUNC>(vistor));
         }
         else {
             // https
-            auto index = id & (0xFFFFFFFF >> 1);
-            FC_ASSERT(index < max_deferred_connection_size);
-            auto con = https_conns[index];
-            FC_ASSERT(con != nullptr);
-
-            if(!vistor(con)) {
-                https_conns[index] = nullptr;
-                https_conn_count--;
-            }
+            visit_connection(https_conns, https_conn_count, id & (0xFFFFFFFF >> 1), std::forward<FUNC>(vistor));
         }
     }
 
@@ -485,7 +525,7 @@ public:
     create_server_for_endpoint(const tcp::endpoint& ep, websocketpp::server<T>& ws) {
         try {
             ws.clear_access_channels(websocketpp::log::alevel::all);
-            ws.init_asio(&app().get_io_service());
+            ws.init_asio(&(*server_ioc));
             ws.set_reuse_addr(true);
             ws.set_max_http_body_size(max_body_size);
             ws.set_http_handler([&](connection_hdl hdl) {
@@ -547,6 +587,8 @@ http_plugin::set_program_options(options_description&, options_description& cfg)
         ("http-max-bytes-in-flight-mb", bpo::value<uint32_t>()->default_value(100),
              "Maximum size in megabytes http_plugin should use for processing http requests. 503 error response when exceeded." )
         ("max-deferred-connection-size", bpo::value<uint32_t>()->default_value(10240), "The maximum size allowed for deferred connections")
+        ("http-threads", bpo::value<uint16_t>()->default_value(my->thread_pool_size),
+            "Number of worker threads in http thread pool, which parse requests, run thread-safe APIs and serialize responses")
         ("verbose-http-errors", bpo::bool_switch()->default_value(false), "Append the error log to HTTP responses")
         ("http-validate-host", boost::program_options::value<bool>()->default_value(true), "If set to false, then any incoming \"Host\" header is considered valid")
         ("http-alias", bpo::value<std::vector<string>>()->composing(),
@@ -634,9 +676,12 @@ http_plugin::plugin_initialize(const variables_map& options) {
         my->max_bytes_in_flight          = options.at("http-max-bytes-in-flight-mb").as<uint32_t>() * 1024 * 1024;
         my->max_deferred_connection_size = options.at("max-deferred-connection-size").as<uint32_t>();
         my->http_no_response             = options.at("http-no-response").as<bool>();
+        my->thread_pool_size             = options.at("http-threads").as<uint16_t>();
         verbose_http_errors              = options.at("verbose-http-errors").as<bool>();
 
         FC_ASSERT(my->max_deferred_connection_size < std::numeric_limits<int32_t>::max());
+        EVT_ASSERT(my->thread_pool_size > 0, chain::plugin_config_exception,
+            "http-threads ${num} must be greater than 0", ("num", my->thread_pool_size));
 
         //watch out for the returns above when adding new code here
     }
@@ -647,9 +692,11 @@ void
 http_plugin::plugin_startup() {
     my->server_ioc = std::make_shared<boost::asio::io_context>();
     my->server_ioc_work.emplace(boost::asio::make_work_guard(*my->server_ioc));
-    my->server_thread.emplace([ioc = my->server_ioc] {
-        ioc->run();
-    });
+    for(auto i = 0u; i < my->thread_pool_size; i++) {
+        my->server_threads.emplace_back([ioc = my->server_ioc] {
+            ioc->run();
+        });
+    }
 
     if(my->listen_endpoint.has_value()) {
         try {
@@ -731,7 +778,7 @@ http_plugin::plugin_startup() {
         }
     }
 
-    add_api({{
+    add_thread_safe_api({{
         std::string("/v1/node/get_supported_apis"),
         [&](string, string body, url_response_callback cb) mutable {
             try {
@@ -763,10 +810,10 @@ http_plugin::plugin_shutdown() {
     if(my->server_ioc) {
         my->server_ioc->stop();
     }
-    if(my->server_thread.has_value()) {
-        my->server_thread->join();
-        my->server_thread.reset();
+    for(auto& t : my->server_threads) {
+        t.join();
     }
+    my->server_threads.clear();
 }
 
 void
@@ -778,12 +825,14 @@ http_plugin::add_handler(const string& url, const url_handler& handler, bool loc
         ilog("add local only api url: ${c}", ("c", url));
     }
     if(!local_only) {
+        auto lock = std::unique_lock<std::shared_mutex>(my->handlers_mutex);
         my->url_handlers.insert(std::make_pair(url, handler));
     }
     else {
         if(!my->unix_endpoint) {
             wlog("Unix server is not enabled, ${u} API cannot be used", ("u",url));
         }
+        auto lock = std::unique_lock<std::shared_mutex>(my->handlers_mutex);
         my->url_local_handlers.insert(std::make_pair(url, handler));
     }
 }
@@ -791,16 +840,28 @@ http_plugin::add_handler(const string& url, const url_handler& handler, bool loc
 void
 http_plugin::add_deferred_handler(const string& url, const url_deferred_handler& handler) {
     ilog("add deferred api url: ${c}", ("c", url));
-    boost::asio::post(app().get_io_service(), [=]() {
-        my->url_deferred_handlers.insert(std::make_pair(url, handler));
-    });
+    auto lock = std::unique_lock<std::shared_mutex>(my->handlers_mutex);
+    my->url_deferred_handlers.insert(std::make_pair(url, handler));
+}
+
+void
+http_plugin::add_thread_safe_handler(const string& url, const url_handler& handler) {
+    ilog("add thread-safe api url: ${c}", ("c", url));
+    auto lock = std::unique_lock<std::shared_mutex>(my->handlers_mutex);
+    my->url_thread_safe_handlers.insert(std::make_pair(url, handler));
 }
 
 void
 http_plugin::set_deferred_response(deferred_id id, int code, const string& body) {
-    boost::asio::post(app().get_io_service(), [=]() {
-        my->set_deferred_response(id, code, body);
-    });
+    // deferred connections are locked, the response is posted to http threads directly
+    my->set_deferred_response(id, code, body);
+}
+
+void
+http_plugin::post_http_thread_pool(std::function<void()> f) {
+    if(my->server_ioc) {
+        boost::asio::post(*my->server_ioc, std::move(f));
+    }
 }
 
 void
@@ -888,11 +949,15 @@ http_plugin::get_supported_apis_result
 http_plugin::get_supported_apis() const {
     get_supported_apis_result result;
 
+    auto lock = std::shared_lock<std::shared_mutex>(my->handlers_mutex);
     for(const auto& handler : my->url_handlers) {
         if(handler.first != "/v1/node/get_supported_apis") {
             result.apis.emplace_back(handler.first);
         }
     }
+    for(const auto& handler : my->url_thread_safe_handlers) {
+        result.apis.emplace_back(handler.first);
+    }
     for(const auto& handler : my->url_deferred_handlers) {
         result.apis.emplace_back(handler.first);
     }
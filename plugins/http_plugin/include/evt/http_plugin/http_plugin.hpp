@@ -79,12 +79,13 @@ struct http_plugin_defaults {
  *  called with the response code and body.
  *
  *  The handler will be called from the appbase application io_service
- *  thread.  The callback can be called from any thread and will 
- *  automatically propagate the call to the http thread.
+ *  thread, except handlers added as thread-safe, which are called from
+ *  the http threads directly.  The callback can be called from any thread
+ *  and will automatically propagate the call to the http threads.
  *
- *  The HTTP service will run in its own thread with its own io_service to
- *  make sure that HTTP request processing does not interfer with other
- *  plugins.  
+ *  The HTTP service will run in its own pool of threads with its own
+ *  io_service to make sure that HTTP request processing does not interfer
+ *  with other plugins.  
  */
 class http_plugin : public appbase::plugin<http_plugin> {
 public:
@@ -104,6 +105,10 @@ public:
     void add_handler(const string& url, const url_handler&, bool local_only = false);
     void add_deferred_handler(const string& url, const url_deferred_handler&);
 
+    // thread-safe handlers are called from http threads, they must not touch chain state
+    // changed by the main thread and should post such work back with app().post()
+    void add_thread_safe_handler(const string& url, const url_handler&);
+
     void
     add_api(const api_description& api, bool local_only = false) {
         for(const auto& call : api) {
@@ -118,8 +123,18 @@ public:
         }
     }
 
+    void
+    add_thread_safe_api(const api_description& api) {
+        for(const auto& call : api) {
+            add_thread_safe_handler(call.first, call.second);
+        }
+    }
+
     void set_deferred_response(deferred_id id, int code, const string& body);
 
+    // runs `f` on http threads, i.e. to serialize responses off the main thread
+    void post_http_thread_pool(std::function<void()> f);
+
     // standard exception handling for api handlers
     static void handle_exception(const char *api_name, const char *call_name, const string& body, url_response_callback cb);
     static void handle_async_exception(deferred_id id, const char *api_name, const char *call_name, const string& body);
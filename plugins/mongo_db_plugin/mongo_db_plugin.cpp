@@ -260,7 +260,10 @@ add_data(bsoncxx::builder::basic::document& act_doc,
         auto& abis    = evt_abi;
         auto  acttype = exec_ctx.get_acttype_name(act.name);
 
-        auto v    = abis.binary_to_variant(acttype, act.data, exec_ctx);
+        auto v = fc::variant();
+        if(!exec_ctx.binary_to_variant(act.name, act.data, v)) {
+            v = abis.binary_to_variant(acttype, act.data, exec_ctx);
+        }
         auto json = fc::json::to_string(v);
         try {
             const auto& value = bsoncxx::from_json(json);
@@ -493,6 +493,7 @@ public:
     peer_block_state_index                   blk_state;
     transaction_state_index                  trx_state;
     optional<sync_state>                     peer_requested;  // this peer is requesting info from us
+    deque<std::pair<uint32_t, std::shared_ptr<vector<char>>>> sync_prefetched;  // send buffers of next requested blocks read from block log
     std::shared_ptr<boost::asio::io_context> server_ioc; // keep ioc alive
     socket_ptr                               socket;
 
@@ -588,6 +589,7 @@ public:
     void cancel_sync(go_away_reason);
     void flush_queues();
     bool enqueue_sync_block();
+    void prefetch_sync_blocks(uint32_t start, uint32_t end);
     void request_sync_blocks(uint32_t start, uint32_t end);
 
     void cancel_wait();
@@ -678,6 +680,7 @@ private:
 
 public:
     explicit sync_manager(uint32_t span);
+    uint32_t req_span() const { return sync_req_span; }
     void set_state(stages s);
     bool sync_required();
     void send_handshakes();
@@ -784,6 +787,7 @@ connection::current() {
 void
 connection::reset() {
     peer_requested.reset();
+    sync_prefetched.clear();
     blk_state.clear();
     trx_state.clear();
 }
@@ -1048,11 +1052,26 @@ connection::enqueue_sync_block() {
     if(!peer_requested.has_value())
         return false;
     uint32_t num          = ++peer_requested->last;
+    uint32_t end          = peer_requested->end_block;
     bool     trigger_send = num == peer_requested->start_block;
     if(num == peer_requested->end_block) {
         peer_requested.reset();
     }
     try {
+        if(!sync_prefetched.empty() && sync_prefetched.front().first != num) {
+            sync_prefetched.clear();
+        }
+        if(sync_prefetched.empty()) {
+            prefetch_sync_blocks(num, end);
+        }
+        if(!sync_prefetched.empty()) {
+            auto buff = std::move(sync_prefetched.front().second);
+            sync_prefetched.pop_front();
+            enqueue_buffer(buff, trigger_send, priority::low, no_reason, true);
+            return true;
+        }
+
+        // reversible blocks are not in block log yet
         controller&      cc = my_impl->chain_plug->chain();
         signed_block_ptr sb = cc.fetch_block_by_number(num);
         if(sb) {
@@ -1109,6 +1128,26 @@ create_send_buffer(uint32_t which, const T& v) {
     return send_buffer;
 }
 
+// builds the frame from packed bytes of `which` message directly, e.g. a block read from block log
+static std::shared_ptr<std::vector<char>>
+create_raw_send_buffer(uint32_t which, const std::string_view& packed) {
+    const uint32_t which_size   = fc::raw::pack_size(unsigned_int(which));
+    const uint32_t payload_size = which_size + packed.size();
+
+    const char* const header     = reinterpret_cast<const char* const>(&payload_size); // avoid variable size encoding of uint32_t
+    constexpr size_t header_size = sizeof(payload_size);
+    static_assert(header_size == message_header_size, "invalid message_header_size");
+    const size_t buffer_size = header_size + payload_size;
+
+    auto send_buffer = std::make_shared<vector<char>>(buffer_size);
+    fc::datastream<char*> ds(send_buffer->data(), buffer_size);
+    ds.write(header, header_size);
+    fc::raw::pack(ds, unsigned_int(which));
+    ds.write(packed.data(), packed.size());
+
+    return send_buffer;
+}
+
 static std::shared_ptr<std::vector<char>>
 create_send_buffer(const signed_block_ptr& sb) {
     // this implementation is to avoid copy of signed_block to net_message
@@ -1123,6 +1162,17 @@ create_send_buffer(const packed_transaction& trx) {
     return create_send_buffer(packed_transaction_which, trx);
 }
 
+void
+connection::prefetch_sync_blocks(uint32_t start, uint32_t end) {
+    // irreversible blocks are sent as they are packed in block log, up to one sync span is read at once
+    auto& cc   = my_impl->chain_plug->chain();
+    auto  last = std::min(end, start + my_impl->sync_master->req_span() - 1);
+    cc.fetch_raw_blocks(start, last, [this](auto num, auto& data) {
+        sync_prefetched.emplace_back(num, create_raw_send_buffer(signed_block_which, data));
+        return true;
+    });
+}
+
 void
 connection::enqueue_block(const signed_block_ptr& sb, bool trigger_send, bool to_sync_queue) {
     enqueue_buffer(create_send_buffer(sb), trigger_send, priority::low, no_reason, to_sync_queue);
@@ -565,15 +565,20 @@ pg::new_copy_context() {
 }
 
 int
-pg::block_copy_to(const std::string& table, const std::string& data) {
+pg::block_copy_to(const std::string& table, const std::vector<const fmt::memory_buffer*>& bufs) {
     auto stmt = fmt::format("COPY {} FROM STDIN;", table);
 
     auto r = PQexec(conn_, stmt.c_str());
     EVT_ASSERT(PQresultStatus(r) == PGRES_COPY_IN, chain::postgres_exec_exception, "Not expected COPY response, detail: ${s}", ("s",PQerrorMessage(conn_)));
     PQclear(r);
 
-    auto nr = PQputCopyData(conn_, data.data(), (int)data.size());
-    EVT_ASSERT(nr == 1, chain::postgres_exec_exception, "Put data into COPY stream failed, detail: ${s}", ("s",PQerrorMessage(conn_)));
+    for(auto buf : bufs) {
+        if(buf->size() == 0) {
+            continue;
+        }
+        auto nr = PQputCopyData(conn_, buf->data(), (int)buf->size());
+        EVT_ASSERT(nr == 1, chain::postgres_exec_exception, "Put data into COPY stream failed, detail: ${s}", ("s",PQerrorMessage(conn_)));
+    }
 
     auto nr2 = PQputCopyEnd(conn_, NULL);
     EVT_ASSERT(nr2 == 1, chain::postgres_exec_exception, "Close data into COPY stream failed, detail: ${s}", ("s",PQerrorMessage(conn_)));
@@ -588,13 +593,33 @@ pg::block_copy_to(const std::string& table, const std::string& data) {
 void
 pg::commit_copy_context(copy_context& cctx) {
     if(cctx.blocks_copy_.size() > 0) {
-        block_copy_to("blocks", fmt::to_string(cctx.blocks_copy_));
+        block_copy_to("blocks", { &cctx.blocks_copy_ });
     }
     if(cctx.trxs_copy_.size() > 0) {
-        block_copy_to("transactions", fmt::to_string(cctx.trxs_copy_));
+        block_copy_to("transactions", { &cctx.trxs_copy_ });
     }
     if(cctx.actions_copy_.size() > 0) {
-        block_copy_to("actions", fmt::to_string(cctx.actions_copy_));
+        block_copy_to("actions", { &cctx.actions_copy_ });
+    }
+}
+
+void
+pg::commit_copy_table(const std::string& table, const std::vector<const copy_context*>& cctxs) {
+    auto bufs = std::vector<const fmt::memory_buffer*>();
+    auto size = 0ul;
+    for(auto cctx : cctxs) {
+        auto buf = &cctx->blocks_copy_;
+        if(table == "transactions") {
+            buf = &cctx->trxs_copy_;
+        }
+        else if(table == "actions") {
+            buf = &cctx->actions_copy_;
+        }
+        bufs.emplace_back(buf);
+        size += buf->size();
+    }
+    if(size > 0) {
+        block_copy_to(table, bufs);
     }
 }
 
@@ -690,9 +715,12 @@ int
 pg::add_action(add_context& actx, const act_trace_t& act_trace, const std::string& trx_id, int seq_num) {
     using namespace internal;
 
-    auto& act     = act_trace.act;
-    auto  acttype = actx.exec_ctx.get_acttype_name(act.name);
-    auto  data    = actx.abi.binary_to_variant(acttype, act.data, actx.exec_ctx);
+    auto& act  = act_trace.act;
+    auto  data = fc::variant();
+    if(!actx.exec_ctx.binary_to_variant(act.name, act.data, data)) {
+        auto acttype = actx.exec_ctx.get_acttype_name(act.name);
+        data         = actx.abi.binary_to_variant(acttype, act.data, actx.exec_ctx);
+    }
 
     fmt::format_to(actx.cctx.actions_copy_,
         fmt("{}\t{:d}\t{}\t{:d}\t{:d}\t{}\t{}\t{}\t{}\tnow\n"),
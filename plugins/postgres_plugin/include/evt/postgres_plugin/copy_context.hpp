@@ -21,6 +21,11 @@ public:
         db_.commit_copy_context(*this);
     }
 
+    size_t
+    size() const {
+        return blocks_copy_.size() + trxs_copy_.size() + actions_copy_.size();
+    }
+
 private:
     fmt::memory_buffer blocks_copy_;
     fmt::memory_buffer trxs_copy_;
@@ -8,7 +8,9 @@
 #include <ostream>
 #include <string>
 #include <string_view>
+#include <vector>
 #include <boost/noncopyable.hpp>
+#include <fmt/format.h>
 #include <evt/chain/block_state.hpp>
 #include <evt/chain/execution_context.hpp>
 #include <evt/chain/transaction.hpp>
@@ -99,6 +101,9 @@ public:
 public:
     copy_context new_copy_context();
     void commit_copy_context(copy_context&);
+    // copies one table ("blocks", "transactions" or "actions") of all the contexts in one COPY,
+    // used when tables are copied over separate connections
+    void commit_copy_table(const std::string& table, const std::vector<const copy_context*>& cctxs);
 
     trx_context new_trx_context();
     void commit_trx_context(trx_context&);
@@ -135,7 +140,7 @@ public:
     int add_ft_holders(trx_context&, const ft_holders_t&);
 
 private:
-    int block_copy_to(const std::string& table, const std::string& data);
+    int block_copy_to(const std::string& table, const std::vector<const fmt::memory_buffer*>& bufs);
 
 private:
     pg_conn*    conn_;
@@ -4,7 +4,9 @@
  */
 #include <evt/postgres_plugin/postgres_plugin.hpp>
 
+#include <array>
 #include <functional>
+#include <future>
 #include <queue>
 #include <optional>
 #include <tuple>
@@ -22,6 +24,7 @@ using boost::condition_variable_any;
 #include <fc/variant.hpp>
 #include <fc/time.hpp>
 #include <fmt/format.h>
+#include <boost/asio/thread_pool.hpp>
 
 #include <evt/chain/config.hpp>
 #include <evt/chain/controller.hpp>
@@ -31,6 +34,7 @@ using boost::condition_variable_any;
 #include <evt/chain/genesis_state.hpp>
 #include <evt/chain/plugin_interface.hpp>
 #include <evt/chain/snapshot.hpp>
+#include <evt/chain/thread_utils.hpp>
 #include <evt/chain/transaction.hpp>
 #include <evt/chain/types.hpp>
 #include <evt/chain/token_database.hpp>
@@ -58,6 +62,12 @@ class postgres_plugin_impl {
 private:
     using inblock_ptr = std::tuple<block_state_ptr, bool>; // true for irreversible block
 
+    // block with matched trace of each transaction (null if not found), formatted into COPY data
+    struct block_copy {
+        block_state_ptr                    block;
+        std::vector<transaction_trace_ptr> traces;
+    };
+
 public:
     postgres_plugin_impl(const controller& control)
         : control_(control)
@@ -77,6 +87,10 @@ public:
     
     void process_action(const action&, trx_context& tctx);
 
+    void format_block(const block_copy&, copy_context& cctx);
+    void copy_blocks_parallel();
+    void report_rate(const block_state_ptr& head);
+
     void verify_last_block(const std::string& prev_block_id);
     void verify_no_blocks();
 
@@ -94,8 +108,24 @@ public:
     uint32_t last_sync_block_num_ = 0;
     uint32_t part_limit_ = 0, part_num_ = 0;
 
-    size_t processed_  = 0;
-    size_t queue_size_ = 0;
+    size_t processed_    = 0;
+    size_t queue_size_   = 0;
+    size_t batch_blocks_ = 0;  // max blocks committed with one checkpoint, 0 for the whole queue
+
+    // parallel copying: COPY data is formatted on `format_pool_`,
+    // and blocks, transactions and actions tables are copied over their own connections
+    uint32_t                                copy_threads_ = 0;
+    std::vector<block_copy>                 copies_;
+    std::optional<boost::asio::thread_pool> format_pool_;
+    std::optional<boost::asio::thread_pool> copy_pool_;
+    std::array<pg, 3>                       copy_dbs_;
+
+    // ingestion rate since last report
+    fc::time_point report_time_;
+    uint64_t       report_blocks_  = 0;
+    uint64_t       report_trxs_    = 0;
+    uint64_t       report_actions_ = 0;
+    uint64_t       report_bytes_   = 0;
 
     std::deque<inblock_ptr>           block_state_queue_;
     std::deque<transaction_trace_ptr> transaction_trace_queue_;
@@ -191,30 +221,39 @@ postgres_plugin_impl::consume_queues() {
                 break;
             }
 
-            auto cctx = db_.new_copy_context();
-            auto tctx = db_.new_trx_context();
-            auto back = std::get<BlockPtr>(bqueue.back()); 
-            // process block states
-            while(true) {
-                if(bqueue.empty()) {
-                    break;
+            // process block states in batches, each one is committed with its last sync block
+            while(!bqueue.empty()) {
+                auto cctx = db_.new_copy_context();
+                auto tctx = db_.new_trx_context();
+                auto back = std::get<BlockPtr>(bqueue.front());
+
+                for(auto n = 0u; !bqueue.empty() && (batch_blocks_ == 0 || n < batch_blocks_); n++) {
+                    auto& b = bqueue.front();
+                    back    = std::get<BlockPtr>(b);
+                    if(std::get<IsIrreversible>(b)) {
+                        process_irreversible_block(back, traces, cctx, tctx);
+                    }
+                    else {
+                        process_block(back, traces, cctx, tctx);
+                    }
+
+                    bqueue.pop_front();
                 }
+                // update last sync block in postgres
+                db_.upd_stat(tctx, "last_sync_block_id", back->id.str());
 
-                auto& b = bqueue.front();
-                if(std::get<IsIrreversible>(b)) {
-                    process_irreversible_block(std::get<BlockPtr>(b), traces, cctx, tctx);
+                // checkpoint is only committed after all the tables are copied
+                if(copy_threads_ > 0) {
+                    copy_blocks_parallel();
                 }
                 else {
-                    process_block(std::get<BlockPtr>(b), traces, cctx, tctx);
+                    report_bytes_ += cctx.size();
+                    cctx.commit();
                 }
+                tctx.commit();
 
-                bqueue.pop_front();
+                report_rate(back);
             }
-            // update last sync block in postgres
-            db_.upd_stat(tctx, "last_sync_block_id", back->id.str());
-
-            cctx.commit();
-            tctx.commit();
 
             if(!traces.empty()) {
                 spinlock_guard lock(lock_);
@@ -384,21 +423,13 @@ postgres_plugin_impl::_process_block(const block_state_ptr block, std::deque<tra
         }
     }
 
-    auto actx      = add_context(cctx, control_.get_chain_id(), control_.get_abi_serializer(), control_.get_execution_context());
-    actx.block_id  = id;
-    actx.block_num = (int)block->block_num;
-    actx.ts        = (std::string)block->header.timestamp.to_time_point();
-
-    db_.add_block(actx, block);
-
-    // transactions
-    auto trx_num = 0;
+    // traces are matched and token tables are updated in order here,
+    // while COPY data of blocks, transactions and actions can be formatted later on other threads
+    auto bc  = block_copy { block, std::vector<transaction_trace_ptr>(block->block->transactions.size()) };
+    auto idx = 0u;
     for(const auto& trx : block->block->transactions) {
-        auto& strx       = trx.trx.get_signed_transaction();
-        auto  trx_id     = strx.id();
-        auto  str_trx_id = strx.id().str();
-        auto  elapsed    = 0;
-        auto  charge     = 0;
+        auto& strx   = trx.trx.get_signed_transaction();
+        auto  trx_id = strx.id();
 
         if(trx.status == transaction_receipt_header::executed && !strx.actions.empty()) {
             auto it = traces.begin();
@@ -407,37 +438,171 @@ postgres_plugin_impl::_process_block(const block_state_ptr block, std::deque<tra
                 traces.pop_front();
 
                 if(trace->id == trx_id) {
-                    elapsed = (int)trace->elapsed.count();
-                    charge  = (int)trace->charge;
-
+                    bc.traces[idx] = trace;
                     if(trace->action_traces.empty()) {
                         break;
                     }
 
+                    auto str_trx_id = trx_id.str();
                     tctx.set_trx_id(str_trx_id);
 
-                    auto act_num = 0;
                     for(auto& act_trace : trace->action_traces) {
-                        db_.add_action(actx, act_trace, str_trx_id, act_num);
                         process_action(act_trace.act, tctx);
                         if(!act_trace.new_ft_holders.empty()) {
                             db_.add_ft_holders(tctx, act_trace.new_ft_holders);
                         }
-                        act_num++;
                     }
+                    report_actions_ += trace->action_traces.size();
                     break;
                 }
                 it++;
             }
         }
+        idx++;
+    }
+    report_blocks_++;
+    report_trxs_ += block->block->transactions.size();
 
-        db_.add_trx(actx, trx, strx, trx_num, elapsed, charge);
-        ++trx_num;
+    if(copy_threads_ > 0) {
+        copies_.emplace_back(std::move(bc));
+    }
+    else {
+        format_block(bc, cctx);
     }
 
     ++processed_;
 }
 
+void
+postgres_plugin_impl::format_block(const block_copy& bc, copy_context& cctx) {
+    try {
+        auto& block = bc.block;
+        auto  id    = block->id.str();
+
+        auto actx      = add_context(cctx, control_.get_chain_id(), control_.get_abi_serializer(), control_.get_execution_context());
+        actx.block_id  = id;
+        actx.block_num = (int)block->block_num;
+        actx.ts        = (std::string)block->header.timestamp.to_time_point();
+
+        db_.add_block(actx, block);
+
+        // transactions
+        auto trx_num = 0;
+        for(const auto& trx : block->block->transactions) {
+            auto& strx    = trx.trx.get_signed_transaction();
+            auto& trace   = bc.traces[trx_num];
+            auto  elapsed = 0;
+            auto  charge  = 0;
+
+            if(trace) {
+                elapsed = (int)trace->elapsed.count();
+                charge  = (int)trace->charge;
+
+                auto str_trx_id = trace->id.str();
+                auto act_num    = 0;
+                for(auto& act_trace : trace->action_traces) {
+                    db_.add_action(actx, act_trace, str_trx_id, act_num);
+                    act_num++;
+                }
+            }
+
+            db_.add_trx(actx, trx, strx, trx_num, elapsed, charge);
+            ++trx_num;
+        }
+    }
+    catch(fc::exception& e) {
+        elog("Exception while formatting block ${e}", ("e", e.to_string()));
+    }
+    catch(std::exception& e) {
+        elog("Exception while formatting block ${e}", ("e", e.what()));
+    }
+    catch(...) {
+        elog("Unknown exception while formatting block");
+    }
+}
+
+void
+postgres_plugin_impl::copy_blocks_parallel() {
+    if(copies_.empty()) {
+        return;
+    }
+
+    // waits for all the tasks before rethrowing, they're referencing locals here
+    auto wait_all = [](auto& futures) {
+        auto except = std::exception_ptr();
+        for(auto& f : futures) {
+            try {
+                f.get();
+            }
+            catch(...) {
+                except = std::current_exception();
+            }
+        }
+        if(except) {
+            std::rethrow_exception(except);
+        }
+    };
+
+    // each worker formats a contiguous range of blocks into its own context
+    auto nworkers = std::min<size_t>(copy_threads_, copies_.size());
+    auto nblocks  = (copies_.size() + nworkers - 1) / nworkers;
+    auto cctxs    = std::vector<std::unique_ptr<copy_context>>();
+    auto formats  = std::vector<std::future<void>>();
+    for(auto i = 0u; i < nworkers; i++) {
+        auto cctx  = cctxs.emplace_back(std::make_unique<copy_context>(db_)).get();
+        auto begin = i * nblocks;
+        auto end   = std::min(begin + nblocks, copies_.size());
+        formats.emplace_back(async_thread_pool(*format_pool_, [this, cctx, begin, end] {
+            for(auto j = begin; j < end; j++) {
+                format_block(copies_[j], *cctx);
+            }
+        }));
+    }
+    wait_all(formats);
+    copies_.clear();
+
+    auto ctxs = std::vector<const copy_context*>();
+    for(auto& cctx : cctxs) {
+        ctxs.emplace_back(cctx.get());
+        report_bytes_ += cctx->size();
+    }
+
+    const char* tables[] = { "blocks", "transactions", "actions" };
+
+    auto copies = std::vector<std::future<void>>();
+    for(auto i = 0u; i < copy_dbs_.size(); i++) {
+        copies.emplace_back(async_thread_pool(*copy_pool_, [this, &ctxs, i, table = tables[i]] {
+            copy_dbs_[i].commit_copy_table(table, ctxs);
+        }));
+    }
+    wait_all(copies);
+}
+
+void
+postgres_plugin_impl::report_rate(const block_state_ptr& head) {
+    auto now = fc::time_point::now();
+    if(report_time_ == fc::time_point()) {
+        report_time_ = now;
+        return;
+    }
+
+    auto elapsed = (now - report_time_).count() / 1000000.0;
+    if(elapsed < 10) {
+        return;
+    }
+
+    ilog("ingested ${b} blocks/s, ${t} trxs/s, ${a} actions/s, ${m} MB/s of COPY data, head block: ${h}",
+        ("b", fmt::format("{:.1f}", report_blocks_ / elapsed))("t", fmt::format("{:.1f}", report_trxs_ / elapsed))
+        ("a", fmt::format("{:.1f}", report_actions_ / elapsed))("m", fmt::format("{:.2f}", report_bytes_ / elapsed / 1024 / 1024))
+        ("h", fmt::format("{:n}", head->block_num)));
+
+    report_time_    = now;
+    report_blocks_  = 0;
+    report_trxs_    = 0;
+    report_actions_ = 0;
+    report_bytes_   = 0;
+}
+
 void
 postgres_plugin_impl::wipe_database() {
     ilog("wipe database");
@@ -512,6 +677,14 @@ postgres_plugin_impl::~postgres_plugin_impl() {
 
         consume_thread_.join();
         db_.close();
+
+        if(copy_threads_ > 0) {
+            format_pool_->join();
+            copy_pool_->join();
+            for(auto& db : copy_dbs_) {
+                db.close();
+            }
+        }
     }
     catch(std::exception& e) {
         elog("Exception on postgres_plugin shutdown of consume thread: ${e}", ("e", e.what()));
@@ -551,6 +724,10 @@ postgres_plugin::set_program_options(options_description& cli, options_descripti
         ("clear-postgres", bpo::bool_switch()->default_value(false), "clear postgres database, use --delete-all-blocks option will force set this option")
         ("postgres-partition-limit", bpo::value<uint>()->default_value(30000000), "The partition limit")
         ("postgres-partition-num", bpo::value<uint>()->default_value(10), "The number of partitions")
+        ("postgres-batch-blocks", bpo::value<uint>()->default_value(0), "Max number of blocks written to postgres in one batch with its last sync block, 0 for all the queued blocks")
+        ("postgres-copy-threads", bpo::value<uint>()->default_value(0),
+            "Number of threads formatting COPY data of blocks, transactions and actions. "
+            "When greater than 0, these tables are also copied over separate connections in parallel")
         ;
 }
 
@@ -591,12 +768,23 @@ postgres_plugin::plugin_initialize(const variables_map& options) {
             my_->queue_size_ = options.at("postgres-queue-size").as<uint>();
         }
 
+        my_->batch_blocks_ = options.at("postgres-batch-blocks").as<uint>();
+        my_->copy_threads_ = options.at("postgres-copy-threads").as<uint>();
+
         auto uri = options.at("postgres-uri").as<std::string>();
         ilog("connecting to ${u}", ("u", uri));
         
         my_->db_.connect(uri);
         my_->connstr_ = uri;
 
+        if(my_->copy_threads_ > 0) {
+            for(auto& db : my_->copy_dbs_) {
+                db.connect(uri);
+            }
+            my_->format_pool_.emplace(my_->copy_threads_);
+            my_->copy_pool_.emplace(my_->copy_dbs_.size());
+        }
+
         if(delete_state) {
             my_->wipe_database();
         }
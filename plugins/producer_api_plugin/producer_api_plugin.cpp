@@ -85,7 +85,13 @@ producer_api_plugin::plugin_startup() {
         CALL(producer, producer, get_integrity_hash,
              INVOKE_R_V(producer, get_integrity_hash), 201),
         CALL(producer, producer, create_snapshot,
-             INVOKE_R_R(producer, create_snapshot, producer_plugin::create_snapshot_options), 201)},
+             INVOKE_R_R(producer, create_snapshot, producer_plugin::create_snapshot_options), 201),
+        CALL(producer, producer, create_snapshot_async,
+             INVOKE_R_R(producer, create_snapshot_async, producer_plugin::create_snapshot_options), 201),
+        CALL(producer, producer, get_snapshot_job,
+             INVOKE_R_R(producer, get_snapshot_job, producer_plugin::get_snapshot_job_params), 201),
+        CALL(producer, producer, get_incoming_stats,
+             INVOKE_R_V(producer, get_incoming_stats), 201)},
         true /* local only API */);
 }
 
@@ -43,6 +43,41 @@ public:
         bool postgres = false;
     };
 
+    // snapshot written in background, see `create_snapshot_async`
+    struct snapshot_job {
+        uint32_t             job_id;
+        std::string          status;  // "running", "done" or "failed"
+        uint32_t             head_block_num;
+        chain::block_id_type head_block_id;
+        fc::time_point       head_block_time;
+        std::string          snapshot_name;
+        uint64_t             sections;  // sections written so far
+        uint64_t             bytes;     // bytes written so far
+        fc::time_point       start_time;
+        int64_t              elapsed_ms;
+        std::string          error;
+    };
+
+    struct get_snapshot_job_params {
+        uint32_t job_id;
+    };
+
+    struct incoming_stats {
+        struct stage {
+            uint64_t count;
+            int64_t  avg_us;
+            int64_t  max_us;
+        };
+
+        uint16_t threads;
+        uint64_t queue_depth;
+        uint64_t max_queue_depth;
+        uint64_t received;
+        stage    recover;  // from arrival until signing keys are recovered
+        stage    wait;     // from recovery until picked up by the main thread
+        stage    apply;    // pushing into the chain
+    };
+
     producer_plugin();
     virtual ~producer_plugin();
 
@@ -66,6 +101,12 @@ public:
     integrity_hash_information get_integrity_hash() const;
     snapshot_information create_snapshot(const create_snapshot_options& options) const;
 
+    // only pins the state at head block, the snapshot is written in background while the chain keeps going
+    snapshot_job create_snapshot_async(const create_snapshot_options& options) const;
+    snapshot_job get_snapshot_job(const get_snapshot_job_params& params) const;
+
+    incoming_stats get_incoming_stats() const;
+
     signal<void(const chain::producer_confirmation&)> confirmed_block;
 
 private:
@@ -78,3 +119,7 @@ FC_REFLECT(evt::producer_plugin::runtime_options, (max_transaction_time)(max_irr
 FC_REFLECT(evt::producer_plugin::integrity_hash_information, (head_block_num)(head_block_id)(head_block_time)(integrity_hash));
 FC_REFLECT(evt::producer_plugin::snapshot_information, (head_block_num)(head_block_id)(head_block_time)(snapshot_name)(postgres));
 FC_REFLECT(evt::producer_plugin::create_snapshot_options, (postgres));
+FC_REFLECT(evt::producer_plugin::snapshot_job, (job_id)(status)(head_block_num)(head_block_id)(head_block_time)(snapshot_name)(sections)(bytes)(start_time)(elapsed_ms)(error));
+FC_REFLECT(evt::producer_plugin::get_snapshot_job_params, (job_id));
+FC_REFLECT(evt::producer_plugin::incoming_stats::stage, (count)(avg_us)(max_us));
+FC_REFLECT(evt::producer_plugin::incoming_stats, (threads)(queue_depth)(max_queue_depth)(received)(recover)(wait)(apply));
@@ -5,7 +5,11 @@
 #include <evt/producer_plugin/producer_plugin.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>
 
 #include <boost/asio.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -24,6 +28,7 @@
 #include <evt/chain/global_property_object.hpp>
 #include <evt/chain/plugin_interface.hpp>
 #include <evt/chain/snapshot.hpp>
+#include <evt/chain/thread_utils.hpp>
 
 #ifdef POSTGRES_SUPPORT
 #include <evt/postgres_plugin/postgres_plugin.hpp>
@@ -84,6 +89,29 @@ using transaction_id_with_expiry_index = multi_index_container<
         hashed_unique<tag<by_id>, BOOST_MULTI_INDEX_MEMBER(transaction_id_with_expiry, transaction_id_type, trx_id)>,
         ordered_non_unique<tag<by_expiry>, BOOST_MULTI_INDEX_MEMBER(transaction_id_with_expiry, fc::time_point, expiry)>>>;
 
+struct incoming_transaction {
+    transaction_metadata_ptr             trx;
+    bool                                 persist_until_expired;
+    next_function<transaction_trace_ptr> next;
+    fc::time_point                       received;
+    fc::time_point                       recovered;
+    std::atomic<bool>                    ready{false};
+};
+using incoming_transaction_ptr = std::shared_ptr<incoming_transaction>;
+
+struct stage_latency {
+    uint64_t count    = 0;
+    int64_t  total_us = 0;
+    int64_t  max_us   = 0;
+
+    void
+    add(const fc::microseconds& us) {
+        count    += 1;
+        total_us += us.count();
+        max_us    = std::max(max_us, us.count());
+    }
+};
+
 enum class pending_block_mode {
     producing,
     speculating
@@ -108,6 +136,32 @@ enum class pending_block_mode {
         NEXT(e.dynamic_copy_exception());                                  \
     }
 
+// reports progress of snapshot written in background after every section
+class snapshot_job_writer : public ostream_snapshot_writer {
+public:
+    snapshot_job_writer(std::ostream& snapshot, std::function<void(uint64_t bytes)> progress)
+        : ostream_snapshot_writer(snapshot)
+        , snapshot(snapshot)
+        , progress(std::move(progress)) {}
+
+    void
+    write_end_section() override {
+        ostream_snapshot_writer::write_end_section();
+        progress(snapshot.tellp());
+    }
+
+protected:
+    void
+    write_section_buffer(snapshot_section_buffer&& buffer) override {
+        ostream_snapshot_writer::write_section_buffer(std::move(buffer));
+        progress(snapshot.tellp());
+    }
+
+private:
+    std::ostream&                        snapshot;
+    std::function<void(uint64_t bytes)> progress;
+};
+
 class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin_impl> {
 public:
     producer_plugin_impl(boost::asio::io_service& io)
@@ -175,6 +229,33 @@ public:
     // path to write the snapshots to
     bfs::path _snapshots_dir;
 
+    // snapshots created by `create_snapshot_async` are written on this pool one at a time
+    optional<boost::asio::thread_pool>                _snapshot_thread_pool;
+    mutable std::mutex                                _snapshot_jobs_mtx;
+    std::map<uint32_t, producer_plugin::snapshot_job> _snapshot_jobs;
+    uint32_t                                          _next_snapshot_job_id = 1;
+
+    void
+    finish_snapshot_job(uint32_t job_id, const std::string& error) {
+        auto lock = std::lock_guard<std::mutex>(_snapshot_jobs_mtx);
+        auto& job = _snapshot_jobs[job_id];
+
+        job.status     = error.empty() ? "done" : "failed";
+        job.error      = error;
+        job.elapsed_ms = (fc::time_point::now() - job.start_time).count() / 1000;
+    }
+
+    // signatures of incoming transactions are recovered on this pool before they reach the main thread
+    optional<boost::asio::thread_pool>   _incoming_thread_pool;
+    uint16_t                             _incoming_trx_threads = 0;
+    std::mutex                           _incoming_mtx;
+    std::deque<incoming_transaction_ptr> _incoming_queue;
+    uint64_t                             _incoming_max_depth = 0;
+    uint64_t                             _incoming_received  = 0;
+    stage_latency                        _recover_latency;
+    stage_latency                        _wait_latency;
+    stage_latency                        _apply_latency;
+
     void
     on_block(const block_state_ptr& bsp) {
         if(bsp->header.timestamp <= _last_signed_block_time)
@@ -357,14 +438,68 @@ public:
 
     void
     on_incoming_transaction_async(const transaction_metadata_ptr& trx, bool persist_until_expired, next_function<transaction_trace_ptr> next) {
-        chain::controller& chain = chain_plug->chain();
-        const auto&        cfg   = chain.get_global_properties().configuration;
+        auto entry = std::make_shared<incoming_transaction>();
+        entry->trx                   = trx;
+        entry->persist_until_expired = persist_until_expired;
+        entry->next                  = std::move(next);
+        entry->received              = fc::time_point::now();
+
+        {
+            std::lock_guard<std::mutex> lock(_incoming_mtx);
+            _incoming_queue.emplace_back(entry);
+            _incoming_received++;
+            _incoming_max_depth = std::max<uint64_t>(_incoming_max_depth, _incoming_queue.size());
+        }
 
-        app().get_io_service().post([self = this, trx, persist_until_expired, next]() {
-            self->process_incoming_transaction_async(trx, persist_until_expired, next);
+        if(!_incoming_thread_pool) {
+            // keys are recovered by controller on the main thread
+            entry->recovered = entry->received;
+            entry->ready.store(true, std::memory_order_release);
+            app().get_io_service().post([self = shared_from_this()]() {
+                self->drain_incoming_transactions();
+            });
+            return;
+        }
+
+        boost::asio::post(*_incoming_thread_pool, [self = shared_from_this(), entry]() {
+            try {
+                entry->trx->recover_keys(self->chain_plug->get_chain_id());
+            }
+            catch(...) {
+                // leave it to push_transaction, which recovers again and reports the failure
+            }
+            entry->recovered = fc::time_point::now();
+            entry->ready.store(true, std::memory_order_release);
+
+            app().get_io_service().post([self]() {
+                self->drain_incoming_transactions();
+            });
         });
     }
 
+    // hands recovered transactions to the chain in the order they arrived
+    void
+    drain_incoming_transactions() {
+        while(true) {
+            auto entry = incoming_transaction_ptr();
+            {
+                std::lock_guard<std::mutex> lock(_incoming_mtx);
+                if(_incoming_queue.empty() || !_incoming_queue.front()->ready.load(std::memory_order_acquire)) {
+                    return;
+                }
+                entry = std::move(_incoming_queue.front());
+                _incoming_queue.pop_front();
+            }
+
+            auto start = fc::time_point::now();
+            _recover_latency.add(entry->recovered - entry->received);
+            _wait_latency.add(start - entry->recovered);
+
+            process_incoming_transaction_async(entry->trx, entry->persist_until_expired, entry->next);
+            _apply_latency.add(fc::time_point::now() - start);
+        }
+    }
+
     void
     process_incoming_transaction_async(const transaction_metadata_ptr& trx, bool persist_until_expired, next_function<transaction_trace_ptr> next) {
         chain::controller& chain = chain_plug->chain();
@@ -550,6 +685,8 @@ producer_plugin::set_program_options(
             "offset of last block producing time in microseconds. Negative number results in blocks to go out sooner, and positive number results in blocks to go out later")
          ("snapshots-dir", bpo::value<bfs::path>()->default_value("snapshots"),
             "the location of the snapshots directory (absolute path or relative to application data dir)")
+         ("incoming-trx-threads", bpo::value<uint16_t>()->default_value(0),
+            "Number of worker threads recovering signatures of incoming transactions before they reach the main thread, 0 to recover on the main thread")
          ;
     config_file_options.add(producer_options); 
 }
@@ -695,6 +832,12 @@ producer_plugin::plugin_initialize(const boost::program_options::variables_map&
                        "No such directory '${dir}'", ("dir", my->_snapshots_dir.generic_string()));
         }
 
+        my->_incoming_trx_threads = options.at("incoming-trx-threads").as<uint16_t>();
+        if(my->_incoming_trx_threads > 0) {
+            my->_incoming_thread_pool.emplace(my->_incoming_trx_threads);
+        }
+        my->_snapshot_thread_pool.emplace(1);
+
         my->_incoming_block_subscription = app().get_channel<incoming::channels::block>().subscribe([this](const signed_block_ptr& block) {
             try {
                 my->on_incoming_block(block);
@@ -772,6 +915,15 @@ producer_plugin::plugin_shutdown() {
         edump((e.to_detail_string()));
     }
 
+    if(my->_incoming_thread_pool) {
+        my->_incoming_thread_pool->stop();
+        my->_incoming_thread_pool->join();
+    }
+    if(my->_snapshot_thread_pool) {
+        // snapshots in background are finished before chain is shut down
+        my->_snapshot_thread_pool->join();
+    }
+
     my->_accepted_block_connection.reset();
     my->_irreversible_block_connection.reset();
 }
@@ -848,6 +1000,26 @@ producer_plugin::get_runtime_options() const {
     };
 }
 
+producer_plugin::incoming_stats
+producer_plugin::get_incoming_stats() const {
+    auto stats = incoming_stats();
+    {
+        std::lock_guard<std::mutex> lock(my->_incoming_mtx);
+        stats.queue_depth     = my->_incoming_queue.size();
+        stats.max_queue_depth = my->_incoming_max_depth;
+        stats.received        = my->_incoming_received;
+    }
+    stats.threads = my->_incoming_trx_threads;
+
+    auto to_stats = [](const stage_latency& l) {
+        return incoming_stats::stage{l.count, l.count ? l.total_us / (int64_t)l.count : 0, l.max_us};
+    };
+    stats.recover = to_stats(my->_recover_latency);
+    stats.wait    = to_stats(my->_wait_latency);
+    stats.apply   = to_stats(my->_apply_latency);
+    return stats;
+}
+
 producer_plugin::integrity_hash_information
 producer_plugin::get_integrity_hash() const {
     chain::controller& chain = my->chain_plug->chain();
@@ -922,6 +1094,123 @@ producer_plugin::create_snapshot(const create_snapshot_options& options) const {
     return {chain.head_block_num(), head_id, chain.head_block_time(), snapshot_path, postgres};
 }
 
+producer_plugin::snapshot_job
+producer_plugin::create_snapshot_async(const create_snapshot_options& options) const {
+    chain::controller& chain = my->chain_plug->chain();
+
+    EVT_ASSERT(!options.postgres, snapshot_exception, "Postgres cannot be written into snapshots created in background");
+
+    auto reschedule = fc::make_scoped_exit([this]() {
+        my->schedule_production_loop();
+    });
+
+    if(chain.pending_block_state()) {
+        // abort the pending block
+        chain.abort_block();
+    }
+    else {
+        reschedule.cancel();
+    }
+
+    auto head_id        = chain.head_block_id();
+    auto id_args        = fc::mutable_variant_object()("id", head_id);
+    auto snapshot_path  = (my->_snapshots_dir / fc::format_string("snapshot-${id}.bin", id_args)).generic_string();
+    auto temp_path      = snapshot_path + ".tmp";
+    auto checkpoint_dir = my->_snapshots_dir / fc::format_string("checkpoint-${id}", id_args);
+
+    EVT_ASSERT(!fc::is_regular_file(snapshot_path), snapshot_exists_exception,
+               "snapshot named ${name} already exists", ("name", snapshot_path));
+    EVT_ASSERT(!fc::exists(temp_path) && !fc::exists(checkpoint_dir), snapshot_exists_exception,
+               "snapshot named ${name} is being created", ("name", snapshot_path));
+
+    auto job            = snapshot_job();
+    job.status          = "running";
+    job.head_block_num  = chain.head_block_num();
+    job.head_block_id   = head_id;
+    job.head_block_time = chain.head_block_time();
+    job.snapshot_name   = snapshot_path;
+    job.sections        = 0;
+    job.bytes           = 0;
+    job.start_time      = fc::time_point::now();
+    job.elapsed_ms      = 0;
+    {
+        auto lock  = std::lock_guard<std::mutex>(my->_snapshot_jobs_mtx);
+        job.job_id = my->_next_snapshot_job_id++;
+        my->_snapshot_jobs.emplace(job.job_id, job);
+    }
+
+    auto self     = my;
+    auto job_id   = job.job_id;
+    auto progress = [self, job_id](uint64_t bytes) {
+        auto lock = std::lock_guard<std::mutex>(self->_snapshot_jobs_mtx);
+        auto& j   = self->_snapshot_jobs[job_id];
+        j.sections++;
+        j.bytes = bytes;
+    };
+
+    auto out    = std::make_shared<std::ofstream>(temp_path, (std::ios::out | std::ios::binary));
+    auto writer = std::make_shared<snapshot_job_writer>(*out, progress);
+
+    // chain state is small and written right now, token database is pinned by a checkpoint
+    try {
+        chain.write_snapshot_checkpoint(writer, checkpoint_dir);
+    }
+    catch(...) {
+        out->close();
+        fc::remove_all(temp_path);
+        fc::remove_all(checkpoint_dir);
+        my->finish_snapshot_job(job_id, "Cannot create checkpoint");
+        throw;
+    }
+
+    boost::asio::post(*my->_snapshot_thread_pool, [self, job_id, out, writer, temp_path, snapshot_path, checkpoint_dir] {
+        auto error = std::string();
+        try {
+            self->chain_plug->chain().write_snapshot_from_checkpoint(writer, checkpoint_dir);
+            writer->finalize();
+            out->flush();
+            out->close();
+            fc::rename(temp_path, snapshot_path);
+        }
+        catch(const fc::exception& e) {
+            error = e.to_detail_string();
+        }
+        catch(const std::exception& e) {
+            error = e.what();
+        }
+        catch(...) {
+            error = "Unknown exception";
+        }
+
+        fc::remove_all(checkpoint_dir);
+        if(!error.empty()) {
+            out->close();
+            fc::remove_all(temp_path);
+            fc_elog(_log, "Writing snapshot ${name} in background failed: ${e}", ("name", snapshot_path)("e", error));
+        }
+        else {
+            fc_ilog(_log, "Snapshot ${name} is written in background", ("name", snapshot_path));
+        }
+        self->finish_snapshot_job(job_id, error);
+    });
+
+    return job;
+}
+
+producer_plugin::snapshot_job
+producer_plugin::get_snapshot_job(const get_snapshot_job_params& params) const {
+    auto lock = std::lock_guard<std::mutex>(my->_snapshot_jobs_mtx);
+
+    auto it = my->_snapshot_jobs.find(params.job_id);
+    EVT_ASSERT(it != my->_snapshot_jobs.end(), snapshot_exception, "Unknown snapshot job: ${id}", ("id", params.job_id));
+
+    auto job = it->second;
+    if(job.status == "running") {
+        job.elapsed_ms = (fc::time_point::now() - job.start_time).count() / 1000;
+    }
+    return job;
+}
+
 optional<fc::time_point>
 producer_plugin_impl::calculate_next_block_time(const account_name& producer_name, const block_timestamp_type& current_block_time) const {
     chain::controller& chain           = chain_plug->chain();
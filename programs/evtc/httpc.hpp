@@ -167,6 +167,7 @@ const std::string producer_paused       = producer_func_base + "/paused";
 const std::string producer_runtime_opts = producer_func_base + "/get_runtime_options";
 const std::string create_snapshot       = producer_func_base + "/create_snapshot";
 const std::string get_integrity_hash    = producer_func_base + "/get_integrity_hash";
+const std::string get_incoming_stats    = producer_func_base + "/get_incoming_stats";
 
 
 const string evtwd_stop = "/v1/evtwd/stop";
@@ -1339,6 +1339,12 @@ struct set_producer_subcommands {
             const auto& v = call(url, get_integrity_hash);
             print_info(v);
         });
+
+        auto iscmd = actionRoot->add_subcommand("incoming_stats", localized("Get queue depth and latencies of incoming transactions"));
+        iscmd->callback([] {
+            const auto& v = call(url, get_incoming_stats);
+            print_info(v);
+        });
     }
 };
 
@@ -1399,6 +1405,7 @@ struct set_get_token_subcommand {
     string name;
     int    skip = 0;
     int    take = 20;
+    string cursor;
 
     set_get_token_subcommand(CLI::App* actionRoot) {
         auto gtcmd = actionRoot->add_subcommand("token", localized("Retrieve a token information"));
@@ -1416,12 +1423,16 @@ struct set_get_token_subcommand {
         gtscmd->add_option("domain", domain, localized("Domain name of token to be retrieved"))->required();
         gtscmd->add_option("--skip,-s", skip, localized("How many records should be skipped"));
         gtscmd->add_option("--take,-t", take, localized("How many records should be returned"));
+        auto gtscursor = gtscmd->add_option("--cursor,-c", cursor, localized("Cursor returned by previous page, empty for the first page"));
 
-        gtscmd->callback([this] {
+        gtscmd->callback([this, gtscursor] {
             auto arg = fc::mutable_variant_object();
             arg.set("domain", domain);
             arg.set("skip", skip);
             arg.set("take", take);
+            if(*gtscursor) {
+                arg.set("cursor", cursor);
+            }
             print_info(call(get_tokens_func, arg));
         });
     }
@@ -1518,8 +1529,9 @@ get_my_resources(const std::string& url) {
 }
 
 struct set_get_my_subcommands {
-    int skip = -1;
-    int take = -1;
+    int    skip = -1;
+    int    take = -1;
+    string cursor;
 
     set_get_my_subcommands(CLI::App* actionRoot) {
         auto mycmd = actionRoot->add_subcommand("my", localized("Retrieve domains, tokens and groups created by user"));
@@ -1548,8 +1560,9 @@ struct set_get_my_subcommands {
         auto trxscmd = mycmd->add_subcommand("transactions", localized("Retrieve my transactions"));
         trxscmd->add_option("--skip,-s", skip, localized("How many records should be skipped"));
         trxscmd->add_option("--take,-t", take, localized("How many records should be returned"));
+        auto trxscursor = trxscmd->add_option("--cursor,-c", cursor, localized("Cursor returned by previous page, empty for the first page"));
 
-        trxscmd->callback([this] {
+        trxscmd->callback([this, trxscursor] {
             auto args = mutable_variant_object();
             args["keys"] = call(wallet_url, wallet_public_keys);
             
@@ -1559,6 +1572,9 @@ struct set_get_my_subcommands {
             if(take > 0) {
                 args["take"] = take;
             }
+            if(*trxscursor) {
+                args["cursor"] = cursor;
+            }
 
             print_info(call(get_transactions, args));
         });
@@ -1575,8 +1591,9 @@ struct set_get_history_subcommands {
 
     string trx_id;
     
-    int skip = -1;
-    int take = -1;
+    int    skip = -1;
+    int    take = -1;
+    string cursor;
 
     set_get_history_subcommands(CLI::App* actionRoot) {
         auto hiscmd = actionRoot->add_subcommand("history", localized("Retrieve actions, transactions history"));
@@ -1588,8 +1605,9 @@ struct set_get_history_subcommands {
         actscmd->add_option("names", names, localized("Names of actions to be retrieved, leave empty to retrieve all actions"));
         actscmd->add_option("--skip,-s", skip, localized("How many records should be skipped"));
         actscmd->add_option("--take,-t", take, localized("How many records should be returned"));
+        auto actscursor = actscmd->add_option("--cursor,-c", cursor, localized("Cursor returned by previous page, empty for the first page"));
 
-        actscmd->callback([this] {
+        actscmd->callback([this, actscursor] {
             auto args = mutable_variant_object();
             args["domain"] = domain;
             if(!key.empty()) {
@@ -1606,6 +1624,9 @@ struct set_get_history_subcommands {
             if(take > 0) {
                 args["take"] = take;
             }
+            if(*actscursor) {
+                args["cursor"] = cursor;
+            }
 
             print_info(call(get_actions, args));
         });
@@ -31,6 +31,25 @@ get_exec_ctx() {
     return exec_ctx;
 }
 
+// verify that conversion via reflected action type reproduces the exact same data as ABI
+void
+verify_reflected_conversion(const type_name& type, const fc::variant& var, const bytes& bytes, const fc::variant& var2) {
+    auto& exec_ctx = get_exec_ctx();
+
+    auto act = name(type);
+    if(exec_ctx.get_acttype_name(act) != type) {
+        return;
+    }
+
+    auto rbytes = chain::bytes();
+    REQUIRE(exec_ctx.variant_to_binary(act, var, rbytes));
+    CHECK(fc::to_hex(bytes) == fc::to_hex(rbytes));
+
+    auto rvar = fc::variant();
+    REQUIRE(exec_ctx.binary_to_variant(act, bytes, rvar));
+    CHECK(fc::json::to_string(var2) == fc::json::to_string(rvar));
+}
+
 // verify that round trip conversion, via bytes, reproduces the exact same data
 fc::variant
 verify_byte_round_trip_conversion(const abi_serializer& abis, const type_name& type, const fc::variant& var) {
@@ -44,6 +63,7 @@ verify_byte_round_trip_conversion(const abi_serializer& abis, const type_name& t
     auto bytes2 = abis.variant_to_binary(type, var2, exec_ctx);
     CHECK(fc::to_hex(bytes) == fc::to_hex(bytes2));
 
+    verify_reflected_conversion(type, var, bytes, var2);
     return var2;
 }
 
@@ -351,6 +371,14 @@ TEST_CASE("transfer_abi_test", "[abis]") {
     CHECK("memo" == trf2.memo);
 
     verify_type_round_trip_conversion<transfer>(abis, "transfer", var);
+
+    // missing fields are rejected by reflected conversion as well as ABI
+    auto mvo = fc::mutable_variant_object(var);
+    mvo.erase("to");
+
+    auto data = bytes();
+    CHECK_FALSE(get_exec_ctx().variant_to_binary(N(transfer), mvo, data));
+    CHECK_THROWS_AS(abis.variant_to_binary("transfer", mvo, get_exec_ctx()), pack_exception);
 }
 
 TEST_CASE("destroytoken_abi_test", "[abis]") {
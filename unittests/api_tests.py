@@ -474,6 +474,100 @@ class Test(unittest.TestCase):
             if i % 100 == 0:
                 print('Received {} responses'.format(i))
 
+    def test_evt_link_for_trx_id5(self):
+        # thousands of concurrent watchers while a few of the links are paid
+        symbol = base.Symbol(
+            sym_name=sym_name, sym_id=sym_id, precision=sym_prec)
+        asset = base.new_asset(symbol)
+
+        url = 'http://127.0.0.1:8888/v1/evt_link/get_trx_id_for_link_id'
+
+        links = []
+        tasks = []
+        for i in range(4000):
+            pay_link = evt_link.EvtLink()
+            pay_link.set_timestamp(int(time.time()))
+            pay_link.set_max_pay(999999999)
+            pay_link.set_header(evt_link.HeaderType.version1.value |
+                                evt_link.HeaderType.everiPay.value)
+            pay_link.set_symbol_id(sym_id)
+            pay_link.set_link_id_rand()
+            pay_link.sign(user.priv_key)
+            links.append(pay_link)
+
+            req = {
+                'link_id': pay_link.get_link_id().hex()
+            }
+            tasks.append(grequests.post(url, data=json.dumps(req)))
+
+        paid = set(random.sample(range(len(links)), 20))
+
+        def get_responses():
+            return grequests.map(tasks, size=len(tasks))
+
+        executor = ThreadPoolExecutor(max_workers=1)
+        f = executor.submit(get_responses)
+
+        time.sleep(1)
+        for i in paid:
+            everipay = AG.new_action('everipay', payee=pub2, number=asset(
+                1), link=links[i].to_string())
+            trx = TG.new_trx()
+            trx.add_action(everipay)
+            trx.add_sign(user.priv_key)
+            trx.set_payer(user.pub_key.to_string())
+            api.push_transaction(trx.dumps())
+
+        resps = f.result()
+        for i, resp in enumerate(resps):
+            self.assertTrue(resp is not None)
+            if i in paid:
+                self.assertEqual(resp.status_code, 200, msg=resp.content)
+                self._test_evt_link_response(resp.text)
+            else:
+                self.assertEqual(resp.status_code, 500, msg=resp.content)
+
+    def test_evt_link_for_trx_id_irreversible(self):
+        symbol = base.Symbol(
+            sym_name=sym_name, sym_id=sym_id, precision=sym_prec)
+        asset = base.new_asset(symbol)
+
+        pay_link = evt_link.EvtLink()
+        pay_link.set_timestamp(int(time.time()))
+        pay_link.set_max_pay(999999999)
+        pay_link.set_header(evt_link.HeaderType.version1.value |
+                            evt_link.HeaderType.everiPay.value)
+        pay_link.set_symbol_id(sym_id)
+        pay_link.set_link_id_rand()
+        pay_link.sign(user.priv_key)
+
+        everipay = AG.new_action('everipay', payee=pub2, number=asset(
+            1), link=pay_link.to_string())
+        trx = TG.new_trx()
+        trx.add_action(everipay)
+        trx.add_sign(user.priv_key)
+        trx.set_payer(user.pub_key.to_string())
+
+        req = {
+            'link_id': pay_link.get_link_id().hex(),
+            'irreversible': True
+        }
+
+        def get_response(req):
+            return api.get_trx_id_for_link_id(json.dumps(req)).text
+
+        executor = ThreadPoolExecutor(max_workers=2)
+        f = executor.submit(get_response, req)
+
+        time.sleep(1)
+        api.push_transaction(trx.dumps())
+
+        resp = f.result()
+        self._test_evt_link_response(resp)
+
+        info = json.loads(api.get_info())
+        self.assertTrue(json.loads(resp)['block_num'] <= info['last_irreversible_block_num'], msg=resp)
+
     def test_get_domains(self):
         req = {
             'keys': [user.pub_key.to_string()]
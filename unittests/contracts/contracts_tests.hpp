@@ -1,5 +1,6 @@
 #include <catch/catch.hpp>
 
+#include <evt/chain/authority_cache.hpp>
 #include <evt/chain/token_database.hpp>
 #include <evt/chain/global_property_object.hpp>
 #include <evt/chain/contracts/evt_link_object.hpp>
@@ -153,6 +153,71 @@ TEST_CASE_METHOD(contracts_test, "updategroup_test", "[contracts]") {
     READ_TOKEN(group, get_group_name(), gp);
     CHECK(6 == gp.root().threshold);
 
+    // domain issued by the group, its authority checks are memoized
+    auto ndvar = fc::json::from_string(R"=====(
+    {
+      "name" : "domain",
+      "creator" : "EVT5ve9Ezv9vLZKp1NmRzvB5ZoZ21YZ533BSB2Ai2jLzzMep6biU2",
+      "issue" : {
+        "name" : "issue",
+        "threshold" : 1,
+        "authorizers": [{
+            "ref": "[G] .OWNER",
+            "weight": 1
+          }
+        ]
+      },
+      "transfer": {
+        "name": "transfer",
+        "threshold": 1,
+        "authorizers": [{
+            "ref": "[G] .OWNER",
+            "weight": 1
+          }
+        ]
+      },
+      "manage": {
+        "name": "manage",
+        "threshold": 1,
+        "authorizers": [{
+            "ref": "[A] EVT5ve9Ezv9vLZKp1NmRzvB5ZoZ21YZ533BSB2Ai2jLzzMep6biU2",
+            "weight": 1
+          }
+        ]
+      }
+    }
+    )=====");
+    auto nd    = ndvar.as<newdomain>();
+    nd.name    = get_domain_name(2);
+    nd.creator = key;
+    nd.issue.authorizers[0].ref.set_group(get_group_name());
+    nd.manage.authorizers[0].ref.set_account(key);
+    my_tester->push_action(action(nd.name, N128(.create), nd), key_seeds, payer);
+    my_tester->produce_blocks();
+
+    auto istk   = issuetoken();
+    istk.domain = nd.name;
+    istk.names  = { "t1" };
+    istk.owner  = { address(key) };
+
+    auto  issue      = action(istk.domain, N128(.issue), istk);
+    auto& auth_cache = my_tester->control->auth_cache();
+
+    // keys of the group created in newgroup_test
+    auto group_keys = public_keys_set();
+    group_keys.insert(public_key_type(std::string("EVT6MRyAjQq8ud7hVNYcfnVPJqcVpscN5So8BhtHuGYqET5GDW5CV")));
+    group_keys.insert(public_key_type(std::string("EVT8MGU4aKiVzqMtWi9zLpu8KuTHZWjQQrX475ycSxEkLd6aBpraX")));
+
+    auto stats = auth_cache.get_stats();
+    CHECK_NOTHROW(my_tester->control->check_authorization(group_keys, issue));
+    CHECK(auth_cache.get_stats().misses > stats.misses);
+
+    // repeated check is answered by the memoized result
+    stats = auth_cache.get_stats();
+    CHECK_NOTHROW(my_tester->control->check_authorization(group_keys, issue));
+    CHECK(auth_cache.get_stats().hits == stats.hits + 1);
+    CHECK(auth_cache.get_stats().misses == stats.misses);
+
     upgrp.group.keys_ = {tester::get_public_key(N(key0)), tester::get_public_key(N(key1)),
                          tester::get_public_key(N(key2)), tester::get_public_key(N(key3)), tester::get_public_key(N(key4))};
     
@@ -176,7 +241,18 @@ TEST_CASE_METHOD(contracts_test, "updategroup_test", "[contracts]") {
     READ_TOKEN(group, get_group_name(), gp);
     CHECK(5 == gp.root().threshold);
 
+    // keys of old group are rejected once group is updated
+    CHECK_THROWS_AS(my_tester->control->check_authorization(group_keys, issue), unsatisfied_authorization);
+
+    // and accepted again after the update is rolled back,
+    // the update is pushed again with the unapplied transactions of aborted block
+    my_tester->control->abort_block();
+    CHECK_NOTHROW(my_tester->control->check_authorization(group_keys, issue));
+
     my_tester->produce_blocks();
+    READ_TOKEN(group, get_group_name(), gp);
+    CHECK(5 == gp.root().threshold);
+    CHECK_THROWS_AS(my_tester->control->check_authorization(group_keys, issue), unsatisfied_authorization);
 
     auto group = group_def();
     READ_TOKEN2(token, N128(.group), name128(get_group_name()), group);
@@ -1,26 +1,57 @@
 #define CATCH_CONFIG_RUNNER
 #include <catch/catch.hpp>
 
+#include <iostream>
+
 #include <fc/filesystem.hpp>
 #include <fc/log/logger.hpp>
 #include <fc/exception/exception.hpp>
 
 #include <llvm/ADT/StringMap.h>
 
+#include <evt/chain/token_database.hpp>
+
 std::string evt_unittests_dir = "tmp/evt_unittests";
 
+// savepoint engine used by token database in tokendb tests
+evt::chain::savepoint_engine evt_unittests_savepoint_engine = evt::chain::savepoint_engine::snapshot;
+
 CATCH_TRANSLATE_EXCEPTION(fc::exception& e) {
     return e.to_detail_string();
 }
 
 int
 main(int argc, char* argv[]) {
+    using namespace Catch::clara;
+
+    auto session = Catch::Session();
+    auto engine  = std::string("snapshot");
+
+    auto cli = session.cli()
+        | Opt(engine, "snapshot|undo-log")["--tokendb-savepoint-engine"]("savepoint engine used by token database");
+    session.cli(cli);
+
+    auto r = session.applyCommandLine(argc, argv);
+    if(r != 0) {
+        return r;
+    }
+
+    if(engine == "undo-log") {
+        evt_unittests_savepoint_engine = evt::chain::savepoint_engine::undo_log;
+        // different directory is used to be run along with default engine
+        evt_unittests_dir += "_undo_log";
+    }
+    else if(engine != "snapshot") {
+        std::cerr << "Unknown savepoint engine: " << engine << std::endl;
+        return 1;
+    }
+
     if(fc::exists(evt_unittests_dir)) {
         fc::remove_all(evt_unittests_dir);
     }
     fc::logger::get().set_log_level(fc::log_level(fc::log_level::error));
 
-    auto result = Catch::Session().run(argc, argv);
+    auto result = session.run();
 
     fc::remove_all(evt_unittests_dir);
     return result;
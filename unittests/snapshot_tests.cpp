@@ -113,3 +113,94 @@ TEST_CASE("snapshot_load_test", "[snapshot]") {
     CHECK(EXISTS_ASSET(addr, 3));
     CHECK(EXISTS_TOKEN(domain, "snapshot-domain"));
 }
+
+TEST_CASE("snapshot_load_rows_test", "[snapshot]") {
+    auto c         = get_db_config();
+    c.db_path      = evt_unittests_dir + "/tokendb_tests/tokendb-rows";
+    c.bulk_restore = false;
+    fc::remove_all(c.db_path);
+
+    auto tokendb = token_database(c);
+    tokendb.open();
+    REQUIRE(!tokendb.bulk_load_supported());
+
+    // restore into an empty tokendb by writing rows one by one
+    auto ss = std::stringstream(token_db_snapshot_);
+    auto reader = std::make_shared<istream_snapshot_reader>(ss);
+
+    token_database_snapshot::read_from_snapshot(reader, tokendb);
+
+    CHECK(EXISTS_TOKEN(domain, "dm-tkdb-test"));
+    CHECK(EXISTS_TOKEN2(token, "dm-tkdb-test", "basic-1"));
+    CHECK(EXISTS_TOKEN2(token, "dm-tkdb-test", "basic-2"));
+
+    auto addr = public_key_type(std::string("EVT8MGU4aKiVzqMtWi9zLpu8KuTHZWjQQrX475ycSxEkLd6aBpraX"));
+    CHECK(EXISTS_ASSET(addr, 3));
+    CHECK(EXISTS_TOKEN(domain, "snapshot-domain"));
+}
+
+TEST_CASE("snapshot_parallel_test", "[snapshot]") {
+    auto tokendb = token_database(get_db_config());
+    tokendb.open();
+
+    auto write = [&](size_t threads) {
+        auto ss     = std::stringstream();
+        auto writer = std::make_shared<ostream_snapshot_writer>(ss);
+        token_database_snapshot::add_to_snapshot(writer, tokendb, threads);
+        writer->finalize();
+        return ss.str();
+    };
+
+    auto hash = [&](size_t threads) {
+        auto enc    = fc::sha256::encoder();
+        auto writer = std::make_shared<integrity_hash_snapshot_writer>(enc);
+        token_database_snapshot::add_to_snapshot(writer, tokendb, threads);
+        writer->finalize();
+        return enc.result();
+    };
+
+    // sections scanned concurrently are written in the same order as the serial ones
+    CHECK(write(1) == write(4));
+    CHECK(hash(1) == hash(4));
+}
+
+TEST_CASE("snapshot_checkpoint_test", "[snapshot]") {
+    auto tokendb = token_database(get_db_config());
+    tokendb.open();
+
+    tokendb.add_savepoint(tokendb.latest_savepoint_seq() + 1);
+
+    // values are kept in write cache of assets while there're savepoints
+    auto addr = public_key_type(std::string("EVT8MGU4aKiVzqMtWi9zLpu8KuTHZWjQQrX475ycSxEkLd6aBpraX"));
+    tokendb.put_asset(addr, 4, "checkpoint-asset");
+
+    auto d = domain_def();
+    d.name = "checkpoint-domain";
+    PUT_DB_TOKEN(domain, std::nullopt, d.name, d);
+
+    auto dir = fc::path(evt_unittests_dir + "/tokendb_tests/checkpoint");
+    fc::remove_all(dir);
+    tokendb.create_checkpoint(dir);
+
+    auto c    = get_db_config();
+    c.db_path = dir;
+
+    auto cpdb = token_database(c);
+    cpdb.open(false);
+
+    CHECK(cpdb.exists_token(token_type::domain, std::nullopt, "checkpoint-domain"));
+    CHECK(cpdb.exists_asset(addr, 4));
+
+    auto write = [](const token_database& db) {
+        auto ss     = std::stringstream();
+        auto writer = std::make_shared<ostream_snapshot_writer>(ss);
+        token_database_snapshot::add_to_snapshot(writer, db);
+        writer->finalize();
+        return ss.str();
+    };
+    CHECK(write(tokendb) == write(cpdb));
+
+    cpdb.close(false);
+    fc::remove_all(dir);
+    tokendb.rollback_to_latest_savepoint();
+}
@@ -1,5 +1,6 @@
 #include "tokendb_tests.hpp"
 #include <evt/chain/token_database_cache.hpp>
+#include <evt/chain/holder_dist_cache.hpp>
 
 TEST_CASE_METHOD(tokendb_test, "cache_test", "[tokendb]") {
     auto& tokendb = my_tester->control->token_db();
@@ -87,4 +88,242 @@ TEST_CASE_METHOD(tokendb_test, "cache_test", "[tokendb]") {
         CHECK(cache.lookup_token<domain_def>(token_type::domain, std::nullopt, "dm-tkdb-cache-2") == nullptr);
         CHECK_THROWS_AS(cache.read_token<domain_def>(token_type::domain, std::nullopt, "dm-tkdb-cache-2") == nullptr, unknown_token_database_key);
     }
+
+    SECTION("asset_test") {
+        auto addr = public_key_type(std::string("EVT8MGU4aKiVzqMtWi9zLpu8KuTHZWjQQrX475ycSxEkLd6aBpraX"));
+        auto sym  = symbol(5, 4);
+
+        auto s = tokendb.new_savepoint_session();
+
+        CHECK(cache.read_asset<property>(addr, sym.id(), true) == nullptr);
+        CHECK_THROWS_AS(cache.read_asset<property>(addr, sym.id()), unknown_token_database_key);
+
+        auto prop   = property();
+        prop.amount = 100;
+        prop.sym    = sym;
+        cache.put_asset(addr, sym.id(), prop);
+        CHECK(EXISTS_ASSET(addr, sym.id()));
+
+        auto p1 = cache.read_asset<property>(addr, sym.id());
+        CHECK(p1 != nullptr);
+        CHECK_EQUAL(prop, *p1);
+
+        // same deserialized object is returned when reading again
+        auto p2 = cache.read_asset<property>(addr, sym.id());
+        CHECK(p1.get() == p2.get());
+        p1.reset();
+        p2.reset();
+
+        CHECK_THROWS_AS(cache.read_asset<domain_def>(addr, sym.id()), token_database_cache_exception);
+
+        {
+            auto s2 = tokendb.new_savepoint_session();
+
+            prop.amount = 50;
+            cache.put_asset(addr, sym.id(), prop);
+            CHECK(cache.read_asset<property>(addr, sym.id())->amount == 50);
+        }
+        // has rollback, cache should serve the previous value
+        CHECK(cache.read_asset<property>(addr, sym.id())->amount == 100);
+
+        // writes bypassing the cache are visible as well
+        prop.amount = 10;
+        PUT_ASSET(addr, sym.id(), prop);
+        CHECK(cache.read_asset<property>(addr, sym.id())->amount == 10);
+
+        s.undo();
+        CHECK(cache.read_asset<property>(addr, sym.id(), true) == nullptr);
+    }
+}
+
+TEST_CASE_METHOD(tokendb_test, "holder_dist_cache_test", "[tokendb]") {
+    auto& tokendb = my_tester->control->token_db();
+    auto  cache   = holder_dist_cache(tokendb, 1024 * 1024);
+    auto  sym     = symbol(5, 88888);
+
+    auto put_asset = [&](const address& addr, int64_t amount) {
+        auto prop   = property();
+        prop.amount = amount;
+        prop.sym    = sym;
+        PUT_ASSET(addr, sym.id(), prop);
+    };
+
+    auto put_holder = [&](uint64_t i, int64_t amount) {
+        put_asset(address(tester::get_public_key(N(holder), name(i))), amount);
+    };
+
+    // distribution should be serialized the same as the one built by a full scan
+    auto CHECK_DIST = [&](const holder_dist& dist) {
+        auto b1 = fc::raw::pack(dist);
+        auto b2 = fc::raw::pack(build_holder_dist(tokendb, sym.id()));
+
+        CHECK(b1.size() == b2.size());
+        CHECK(memcmp(b1.data(), b2.data(), b1.size()) == 0);
+    };
+
+    // pairs of generated addresses whose hashes collide in slim map
+    auto colls = std::vector<address>();
+    auto seen  = std::unordered_map<uint32_t, address>();
+    for(auto n = 0u; colls.size() < 4; n++) {
+        auto addr = address(N(holder), N128(dist), n);
+
+        char buf[sizeof(fc::ecc::public_key_shim)];
+        addr.to_bytes(buf, sizeof(buf));
+
+        auto h  = fc::city_hash32(buf, sizeof(buf));
+        auto it = seen.find(h);
+        if(it != seen.end()) {
+            colls.emplace_back(it->second);
+            colls.emplace_back(addr);
+            continue;
+        }
+        seen.emplace(h, addr);
+    }
+
+    auto s = tokendb.new_savepoint_session();
+    for(auto i = 0; i < 100; i++) {
+        put_holder(i, 100 + i);
+    }
+
+    CHECK_DIST(cache.get(sym.id()));
+    CHECK(cache.get_stats().builds == 1);
+
+    {
+        auto s2 = tokendb.new_savepoint_session();
+
+        put_holder(1, 0);
+        put_holder(2, 500);
+        put_holder(100, 50);
+        CHECK_DIST(cache.get(sym.id()));
+        CHECK(cache.get(sym.id()).total == 100 * 100 + 99 * 50 - 101 + 398 + 50);
+
+        put_holder(101, 60);
+    }
+    // rolled back holders are synced as well
+    CHECK_DIST(cache.get(sym.id()));
+    CHECK(cache.get(sym.id()).total == 100 * 100 + 99 * 50);
+
+    auto stats = cache.get_stats();
+    CHECK(stats.builds == 1);
+    CHECK(stats.symbols == 1);
+    CHECK(stats.holders == 100);
+    CHECK(stats.synced_holders == 3 + 4);
+
+    {
+        auto s3 = tokendb.new_savepoint_session();
+
+        put_asset(colls[1], 10);
+        CHECK_DIST(cache.get(sym.id()));
+        {
+            auto s4 = tokendb.new_savepoint_session();
+
+            put_asset(colls[0], 20);
+            put_asset(colls[2], 30);
+            CHECK_DIST(cache.get(sym.id()));
+            CHECK(cache.get(sym.id()).coll.size() == 1);
+
+            put_asset(colls[3], 40);
+            put_asset(colls[1], 15);
+            CHECK_DIST(cache.get(sym.id()));
+            CHECK(cache.get(sym.id()).coll.size() == 2);
+        }
+        // colliding holders removed by rollback
+        CHECK_DIST(cache.get(sym.id()));
+        CHECK(cache.get(sym.id()).coll.empty());
+
+        put_asset(colls[3], 45);
+        put_asset(colls[0], 25);
+        put_holder(3, 0);
+        CHECK_DIST(cache.get(sym.id()));
+        CHECK(cache.get(sym.id()).coll.size() == 1);
+    }
+    CHECK_DIST(cache.get(sym.id()));
+    CHECK(cache.get(sym.id()).total == 100 * 100 + 99 * 50);
+    CHECK(cache.get_stats().builds == 1);
+
+    // symbols beyond the limit are not kept
+    auto cache2 = holder_dist_cache(tokendb, 50);
+    CHECK_DIST(cache2.get(sym.id()));
+    CHECK(cache2.get_stats().symbols == 0);
+    CHECK(cache2.get_stats().evictions == 1);
+
+    s.undo();
+    CHECK_DIST(cache.get(sym.id()));
+    CHECK(cache.get(sym.id()).total == 0);
+}
+
+TEST_CASE("persist_rollback_cache_test", "[tokendb]") {
+    // savepoints are persisted and loaded back without a controller
+    auto cfg = token_database::config();
+    cfg.db_path = evt_unittests_dir + "/tokendb_tests/tokendb_prst_cache";
+    cfg.engine  = evt_unittests_savepoint_engine;
+    if(fc::exists(cfg.db_path)) {
+        fc::remove_all(cfg.db_path);
+    }
+
+    auto tokendb = token_database(cfg);
+    tokendb.open();
+
+    auto var = fc::json::from_string(domain_data);
+    auto dom = var.as<domain_def>();
+    auto sym = symbol(5, 88890);
+
+    auto put_domain = [&](const char* dom_name, const char* creator) {
+        dom.name    = dom_name;
+        dom.creator = tester::get_public_key(creator);
+        PUT_TOKEN(domain, dom.name, dom);
+    };
+
+    auto put_holder = [&](uint64_t i, int64_t amount) {
+        auto prop   = property();
+        prop.amount = amount;
+        prop.sym    = sym;
+        PUT_ASSET(address(tester::get_public_key(N(holder), name(i))), sym.id(), prop);
+    };
+
+    tokendb.add_savepoint(1);
+    put_domain("domain-prst", "sp1");
+    for(auto i = 0; i < 10; i++) {
+        put_holder(i, 100);
+    }
+
+    tokendb.add_savepoint(2);
+    put_domain("domain-prst", "sp2");
+    put_domain("domain-prst2", "sp2");
+    put_holder(1, 0);
+    put_holder(2, 300);
+    put_holder(10, 50);
+
+    // savepoints are rolled back from the persisted log after reopening
+    tokendb.close();
+    tokendb.open();
+    CHECK(tokendb.savepoints_size() == 2);
+
+    auto cache  = token_database_cache(tokendb, 1024 * 1024);
+    auto holder = holder_dist_cache(tokendb, 1024 * 1024);
+
+    auto CHECK_DIST = [&](int64_t total) {
+        auto b1 = fc::raw::pack(holder.get(sym.id()));
+        auto b2 = fc::raw::pack(build_holder_dist(tokendb, sym.id()));
+
+        CHECK(b1.size() == b2.size());
+        CHECK(memcmp(b1.data(), b2.data(), b1.size()) == 0);
+        CHECK(holder.get(sym.id()).total == total);
+    };
+
+    CHECK(cache.read_token<domain_def>(token_type::domain, std::nullopt, "domain-prst")->creator == tester::get_public_key("sp2"));
+    CHECK(cache.read_token<domain_def>(token_type::domain, std::nullopt, "domain-prst2") != nullptr);
+    CHECK_DIST(100 * 10 - 100 + 200 + 50);
+
+    // caches are notified of values restored from persisted savepoints
+    tokendb.rollback_to_latest_savepoint();
+    CHECK(cache.read_token<domain_def>(token_type::domain, std::nullopt, "domain-prst")->creator == tester::get_public_key("sp1"));
+    CHECK(cache.read_token<domain_def>(token_type::domain, std::nullopt, "domain-prst2", true) == nullptr);
+    CHECK_DIST(100 * 10);
+
+    tokendb.rollback_to_latest_savepoint();
+    CHECK(cache.read_token<domain_def>(token_type::domain, std::nullopt, "domain-prst", true) == nullptr);
+    CHECK_DIST(0);
+
+    tokendb.close();
 }
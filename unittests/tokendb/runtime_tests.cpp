@@ -1,4 +1,5 @@
 #include "tokendb_tests.hpp"
+#include <algorithm>
 
 TEST_CASE_METHOD(tokendb_test, "add_token_svpt_test", "[tokendb]") {
     auto& tokendb = my_tester->control->token_db();
@@ -236,3 +237,209 @@ TEST_CASE_METHOD(tokendb_test, "squansh_test", "[tokendb]") {
 
     my_tester->produce_block();
 }
+
+TEST_CASE_METHOD(tokendb_write_cache_test, "write_cache_svpt_test", "[tokendb]") {
+    auto& tokendb = my_tester->control->token_db();
+    my_tester->produce_block();
+
+    ADD_SAVEPOINT();
+
+    auto var = fc::json::from_string(domain_data);
+    auto dom = var.as<domain_def>();
+    dom.name = "domain-wc";
+    CHECK(!EXISTS_TOKEN(domain, dom.name));
+    PUT_TOKEN(domain, dom.name, dom);
+    CHECK(EXISTS_TOKEN(domain, dom.name));
+
+    var = fc::json::from_string(token_data);
+    auto tk = var.as<token_def>();
+    tk.domain = dom.name;
+    tk.name   = "tk-wc";
+    ADD_TOKEN2(token, dom.name, tk.name, tk);
+
+    ADD_SAVEPOINT();
+
+    tk.metas.clear();
+    tk.owner = { address(key) };
+    UPDATE_TOKEN2(token, dom.name, tk.name, tk);
+
+    auto tk2 = token_def();
+    READ_TOKEN2(token, dom.name, tk.name, tk2);
+    CHECK(tk2.owner.size() == 1);
+    CHECK(tk2.owner[0] == address(key));
+
+    // values in write cache should be visible to range reads
+    auto count = tokendb.read_tokens_range(token_type::token, dom.name, 0, [](auto& key, auto&& value) {
+        return true;
+    });
+    CHECK(count == 1);
+
+    ROLLBACK();
+
+    // update is reverted
+    READ_TOKEN2(token, dom.name, tk.name, tk2);
+    CHECK(tk2.owner[0] != address(key));
+
+    ROLLBACK();
+    CHECK(!EXISTS_TOKEN(domain, dom.name));
+    CHECK(!EXISTS_TOKEN2(token, dom.name, tk.name));
+
+    my_tester->produce_block();
+}
+
+TEST_CASE("write_cache_pop_test", "[tokendb]") {
+    // savepoints are managed here without a controller
+    auto cfg = token_database::config();
+    cfg.db_path            = evt_unittests_dir + "/tokendb_tests/tokendb_pop";
+    cfg.tokens_write_cache = true;
+    cfg.engine             = evt_unittests_savepoint_engine;
+    if(fc::exists(cfg.db_path)) {
+        fc::remove_all(cfg.db_path);
+    }
+
+    auto tokendb = token_database(cfg);
+    tokendb.open();
+
+    auto var = fc::json::from_string(domain_data);
+    auto dom = var.as<domain_def>();
+    dom.name = "domain-pop";
+
+    auto addr = address(tester::get_public_key(N(pop)));
+    auto sym  = symbol(5, 88889);
+    auto prop = property();
+    prop.sym  = sym;
+
+    auto put = [&](const char* creator, int64_t amount) {
+        dom.creator = tester::get_public_key(creator);
+        PUT_TOKEN(domain, dom.name, dom);
+
+        prop.amount = amount;
+        PUT_ASSET(addr, sym.id(), prop);
+    };
+
+    auto CHECK_VALUES = [&](const char* creator, int64_t amount) {
+        auto dom2 = domain_def();
+        READ_TOKEN(domain, dom.name, dom2);
+        CHECK(dom2.creator == tester::get_public_key(creator));
+
+        auto str   = std::string();
+        auto prop2 = property();
+        tokendb.read_asset(addr, sym.id(), str);
+        extract_db_value(str, prop2);
+        CHECK(prop2.amount == amount);
+    };
+
+    tokendb.add_savepoint(1);
+    put("sp1", 100);
+    tokendb.add_savepoint(2);
+    put("sp2", 200);
+
+    // first savepoint becomes irreversible while the same keys are still written by the second one
+    tokendb.pop_savepoints(2);
+    ROLLBACK();
+    CHECK(tokendb.savepoints_size() == 0);
+    CHECK_VALUES("sp1", 100);
+
+    tokendb.add_savepoint(3);
+    put("sp3", 300);
+    tokendb.add_savepoint(4);
+    put("sp4", 400);
+    put("sp4x", 410);
+
+    // write cache is persisted with the value of each write and loaded back
+    tokendb.close();
+    tokendb.open();
+    CHECK(tokendb.savepoints_size() == 2);
+    CHECK_VALUES("sp4x", 410);
+
+    ROLLBACK();
+    CHECK_VALUES("sp3", 300);
+
+    tokendb.pop_savepoints(4);
+    CHECK_VALUES("sp3", 300);
+
+    tokendb.close();
+}
+
+// runs range scans over tokens either staged in write cache or written into db directly
+static void
+check_scan_range(tester& t) {
+    auto& tokendb = t.control->token_db();
+    t.produce_block();
+
+    ADD_SAVEPOINT();
+
+    auto var = fc::json::from_string(domain_data);
+    auto dom = var.as<domain_def>();
+    dom.name = "domain-scan";
+    PUT_TOKEN(domain, dom.name, dom);
+
+    var = fc::json::from_string(token_data);
+    auto tk = var.as<token_def>();
+    tk.domain = dom.name;
+    for(auto i = 0; i < 3; i++) {
+        tk.name = name128::from_number(i);
+        ADD_TOKEN2(token, dom.name, tk.name, tk);
+    }
+
+    ADD_SAVEPOINT();
+
+    auto key = t.get_public_key("scan");
+    tk.name  = name128::from_number(1);
+    tk.owner = { address(key) };
+    UPDATE_TOKEN2(token, dom.name, tk.name, tk);
+
+    // tokens of neighbouring domains are not scanned
+    ADD_TOKEN2(token, "domain-scan1", tk.name, tk);
+    ADD_TOKEN2(token, "domain-scao", tk.name, tk);
+
+    auto keys  = std::vector<std::string>();
+    auto count = tokendb.scan_tokens_range(token_type::token, dom.name, std::string_view(), [&](auto& k, auto& v) {
+        auto tk2 = token_def();
+        extract_db_value(v, tk2);
+        if(tk2.name == tk.name) {
+            // latest value is visible
+            CHECK(tk2.owner[0] == address(key));
+        }
+        keys.emplace_back(k);
+        return true;
+    });
+    CHECK(count == 3);
+    REQUIRE(keys.size() == 3);
+    CHECK(std::is_sorted(keys.cbegin(), keys.cend()));
+
+    // continue from the second key
+    auto keys2 = std::vector<std::string>();
+    count = tokendb.scan_tokens_range(token_type::token, dom.name, keys[1], [&](auto& k, auto& v) {
+        keys2.emplace_back(k);
+        return true;
+    });
+    CHECK(count == 2);
+    CHECK(keys2 == std::vector<std::string>(keys.cbegin() + 1, keys.cend()));
+
+    // stop early
+    count = tokendb.scan_tokens_range(token_type::token, dom.name, std::string_view(), [&](auto& k, auto& v) {
+        return false;
+    });
+    CHECK(count == 1);
+
+    // skip based reads are built on scans
+    count = tokendb.read_tokens_range(token_type::token, dom.name, 1, [](auto& k, auto&& v) {
+        return true;
+    });
+    CHECK(count == 2);
+
+    ROLLBACK();
+    ROLLBACK();
+    CHECK(!EXISTS_TOKEN(domain, dom.name));
+
+    t.produce_block();
+}
+
+TEST_CASE_METHOD(tokendb_write_cache_test, "scan_range_test", "[tokendb]") {
+    check_scan_range(*my_tester);
+}
+
+TEST_CASE_METHOD(tokendb_test, "scan_range_db_test", "[tokendb]") {
+    check_scan_range(*my_tester);
+}
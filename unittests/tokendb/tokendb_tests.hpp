@@ -24,12 +24,13 @@ using namespace testing;
 using namespace fc;
 using namespace crypto;
 
-extern std::string evt_unittests_dir;
+extern std::string                  evt_unittests_dir;
+extern evt::chain::savepoint_engine evt_unittests_savepoint_engine;
 
 class tokendb_test {
 public:
     //tokendb_test() : tokendb(evt_unittests_dir + "/tokendb_tests") {
-    tokendb_test() {
+    tokendb_test(bool tokens_write_cache = false) {
         auto basedir = evt_unittests_dir + "/tokendb_tests";
         if(!fc::exists(basedir)) {
             fc::create_directories(basedir);
@@ -39,6 +40,8 @@ public:
         cfg.blocks_dir            = basedir + "/blocks";
         cfg.state_dir             = basedir + "/state";
         cfg.db_config.db_path     = basedir + "/tokendb";
+        cfg.db_config.tokens_write_cache = tokens_write_cache;
+        cfg.db_config.engine             = evt_unittests_savepoint_engine;
         cfg.contracts_console     = true;
         cfg.charge_free_mode      = false;
         cfg.loadtest_mode         = false;
@@ -59,6 +62,11 @@ protected:
     std::unique_ptr<tester>   my_tester;
 };
 
+class tokendb_write_cache_test : public tokendb_test {
+public:
+    tokendb_write_cache_test() : tokendb_test(true /* tokens_write_cache */) {}
+};
+
 #define EXISTS_TOKEN(TYPE, NAME) \
     tokendb.exists_token(evt::chain::token_type::TYPE, std::nullopt, NAME)
 